@@ -1,14 +1,44 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <cmath>
+#include <cstdio>
 #include <iostream>
+#include <stdexcept>
 #include <vector>
 #include <fstream>
+#include <unordered_map>
 
 #include "simd.h"
+#include "pipeline.h"
+#include "rigid_transform.h"
+#include "projection.h"
+#include "zip.h"
+#include "reduction.h"
+#include "parallel.h"
+#include "histogram.h"
+#include "tiling.h"
+#include "simd_registry.h"
+#include "normals.h"
+#include "temporal_filter.h"
+#include "decimation.h"
+#include "color.h"
+#include "voxel_grid.h"
+#include "point_cloud_writer.h"
+#include "ray_cache.h"
+#include "sparse.h"
+#include "async.h"
+#include "numa.h"
 
 struct float2 { float x; float y; };
 struct float3 { float x; float y; float z; };
 struct float4 { float x; float y; float z; float w; };
 struct float5 { float x; float y; float z; float w; float u; };
+struct double2 { double x; double y; };
+struct double3 { double x; double y; double z; };
+struct vertex { float3 position; float3 normal; unsigned int color; float pad; };
+struct padded_float5 { float5 value; float pad[3]; };
 
 typedef struct rs2_intrinsics
 {
@@ -49,6 +79,9 @@ struct test_app
         rs2_intrinsics intr{ 640, 480, 100, 200, 50, 70 };
         rs2_extrinsics extr{ { 1.1, 0.9, 0.2, 0.3, 0.9, 0.7, 0, 0.2, 0.3 },{ 0.1, 0.5, 0.6 } };
 
+        const simd::rigid_transform_kernel<typename T::engine_t> to_point(
+            simd::rigid_transform(extr.rotation, extr.translation));
+
         for (auto i : ptr)
         {
             auto block = i.load();
@@ -57,37 +90,939 @@ struct test_app
             auto y = soa[1];
             auto z = soa[2];
 
-            auto to_point_x = x* extr.rotation[0] + y* extr.rotation[3] + z * extr.rotation[6] + extr.translation[0];
-            auto to_point_y = x* extr.rotation[1] + y* extr.rotation[4] + z * extr.rotation[7] + extr.translation[1];
-            auto to_point_z = x* extr.rotation[2] + y* extr.rotation[5] + z * extr.rotation[8] + extr.translation[2];
+            decltype(x) to_point_x, to_point_y, to_point_z;
+            to_point.apply(x, y, z, to_point_x, to_point_y, to_point_z);
+
+            auto u1 = to_point_x / to_point_z, v1 = to_point_y / to_point_z;
+
+
+            auto px = u1 * intr.fx + intr.ppx;
+            auto py = v1 * intr.fy + intr.ppy;
+
+            auto u = px / (intr.width);
+            auto v = py / (intr.height);
+
+            auto out_block = i.scatter(u, v);
+            //auto out_block = i.scatter(x, y);
+            i.store(out_block);
+        }
+    }
+};
+
+// Camera c of test_multi_app: intrinsics and translation shift with c
+template<class K>
+K test_camera(int c)
+{
+    rs2_intrinsics intr{ 640.f, 480.f, 100.f + 10 * c, 200.f, 50.f, 70.f + 5 * c };
+    rs2_extrinsics extr{ { 1.1, 0.9, 0.2, 0.3, 0.9, 0.7, 0, 0.2, 0.3 },{ 0.1f * (c + 1), 0.5, 0.6 } };
+    simd::pinhole model{ intr.width, intr.height, intr.ppx, intr.ppy, intr.fx, intr.fy };
+    return K(simd::rigid_transform(extr.rotation, extr.translation), model);
+}
+
+// Projects the same points into several cameras, gathering the input only once
+template<class T>
+struct test_multi_app
+{
+    void operator()(T& ptr)
+    {
+        // Kept on the stack, the broadcast registers need their natural alignment
+        typedef simd::projection_kernel<typename T::engine_t> kernel;
+        kernel cameras[T::outputs];
+        for (int c = 0; c < T::outputs; c++) cameras[c] = test_camera<kernel>(c);
+
+        for (auto i : ptr)
+        {
+            auto block = i.load();
+            auto soa = i.gather(block);
+
+            for (int c = 0; c < T::outputs; c++)
+            {
+                typename T::gather_type u, v;
+                cameras[c].apply(soa[0], soa[1], soa[2], u, v);
+                i.store(c, i.scatter(u, v));
+            }
+        }
+    }
+};
+
+// One camera of test_multi_app on a plain transformation
+template<class T>
+struct test_camera_app
+{
+    int camera;
+
+    void operator()(T& ptr)
+    {
+        typedef simd::projection_kernel<typename T::engine_t> kernel;
+        const kernel model = test_camera<kernel>(camera);
+
+        for (auto i : ptr)
+        {
+            auto soa = i.gather(i.load());
+            typename T::gather_type u, v;
+            model.apply(soa[0], soa[1], soa[2], u, v);
+            i.store(i.scatter(u, v));
+        }
+    }
+};
+
+// Same projection as test_app, every step in double precision
+template<class T>
+struct test_double_app
+{
+    void operator()(T& ptr)
+    {
+        rs2_intrinsics intr{ 640, 480, 100, 200, 50, 70 };
+        rs2_extrinsics extr{ { 1.1, 0.9, 0.2, 0.3, 0.9, 0.7, 0, 0.2, 0.3 },{ 0.1, 0.5, 0.6 } };
+        double r[9], translation[3];
+        for (int k = 0; k < 9; k++) r[k] = extr.rotation[k];
+        for (int k = 0; k < 3; k++) translation[k] = extr.translation[k];
+
+        for (auto i : ptr)
+        {
+            auto soa = i.gather(i.load());
+            auto x = soa[0], y = soa[1], z = soa[2];
+
+            auto to_point_x = x * r[0] + y * r[3] + z * r[6] + translation[0];
+            auto to_point_y = x * r[1] + y * r[4] + z * r[7] + translation[1];
+            auto to_point_z = x * r[2] + y * r[5] + z * r[8] + translation[2];
+
+            auto px = to_point_x / to_point_z * (double)intr.fx + (double)intr.ppx;
+            auto py = to_point_y / to_point_z * (double)intr.fy + (double)intr.ppy;
+
+            i.store(i.scatter(px / (double)intr.width, py / (double)intr.height));
+        }
+    }
+};
+
+// Reads every component of five-float records, (x + w, u) out
+template<class T>
+struct test_components_app
+{
+    void operator()(T& ptr)
+    {
+        for (auto i : ptr)
+        {
+            auto soa = i.gather(i.load());
+            i.store(i.scatter(soa[0] + soa[3], soa[4]));
+        }
+    }
+};
+
+// Re-frames points into another coordinate system, float3 -> float3
+template<class T>
+struct test_reframe_app
+{
+    void operator()(T& ptr)
+    {
+        rs2_extrinsics extr{ { 1.1, 0.9, 0.2, 0.3, 0.9, 0.7, 0, 0.2, 0.3 },{ 0.1, 0.5, 0.6 } };
+        const simd::rigid_transform_kernel<typename T::engine_t> to_point(
+            simd::rigid_transform(extr.rotation, extr.translation));
+
+        for (auto i : ptr)
+        {
+            auto soa = i.gather(i.load());
+
+            typename T::gather_type x, y, z;
+            to_point.apply(soa[0], soa[1], soa[2], x, y, z);
+            i.store(i.scatter(x, y, z));
+        }
+    }
+};
+
+// Two streams zipped in one pass: points scaled by their infrared confidence
+template<class T>
+struct test_zip_app
+{
+    void operator()(T& ptr)
+    {
+        const simd::broadcast<typename T::engine_t, float> ir_scale(1.f / 255.f);
+
+        for (auto i : ptr)
+        {
+            auto xyz = i.template fetch<0>();
+            auto ir = i.template fetch<1>();
+
+            auto confidence = ir[0] * ir_scale;
+            i.store(i.scatter(xyz[0] * confidence, xyz[1] * confidence, xyz[2] * confidence));
+        }
+    }
+};
+
+// Projection that also collects bounding box, centroid and valid count on the way
+template<class T>
+struct test_stats_app
+{
+    int frames = 1;
+
+    simd::cloud_statistics operator()(T& ptr)
+    {
+        typedef typename T::engine_t E;
+        rs2_intrinsics intr{ 640, 480, 100, 200, 50, 70 };
+        rs2_extrinsics extr{ { 1.1, 0.9, 0.2, 0.3, 0.9, 0.7, 0, 0.2, 0.3 },{ 0.1, 0.5, 0.6 } };
+
+        const simd::projection_kernel<E> camera(simd::rigid_transform(extr.rotation, extr.translation),
+            simd::pinhole{ intr.width, intr.height, intr.ppx, intr.ppy, intr.fx, intr.fy });
+        const simd::broadcast<E, float> zero(0.f);
+        simd::statistics_accumulator<E> stats;
+
+        for (int f = 0; f < frames; f++)
+        for (auto i : ptr)
+        {
+            auto block = i.load();
+            auto soa = i.gather(block);
+
+            typename T::gather_type u, v;
+            camera.apply(soa[0], soa[1], soa[2], u, v);
+            i.store(i.scatter(u, v));
+
+            stats.add(soa[0], soa[1], soa[2], soa[2].greater(zero));
+        }
+        return stats.result();
+    }
+};
+
+// Projection written as 16-bit (u, v), encoded as F on the way out
+template<class T, class F>
+struct test_encoded_app
+{
+    uint16_t* target;
+
+    void operator()(T& ptr)
+    {
+        typedef typename T::engine_t E;
+        rs2_intrinsics intr{ 640, 480, 100, 200, 50, 70 };
+        rs2_extrinsics extr{ { 1.1, 0.9, 0.2, 0.3, 0.9, 0.7, 0, 0.2, 0.3 },{ 0.1, 0.5, 0.6 } };
+
+        const simd::projection_kernel<E> camera(simd::rigid_transform(extr.rotation, extr.translation),
+            simd::pinhole{ intr.width, intr.height, intr.ppx, intr.ppy, intr.fx, intr.fy });
+
+        for (auto i : ptr)
+        {
+            auto soa = i.gather(i.load());
+
+            typename T::gather_type u, v;
+            camera.apply(soa[0], soa[1], soa[2], u, v);
+            i.store(i.scatter(u, v), target, F());
+        }
+    }
+};
+
+// Projection of points that are themselves stored as 16-bit values
+template<class T, class F>
+struct test_decoded_app
+{
+    const uint16_t* source;
+
+    void operator()(T& ptr)
+    {
+        typedef typename T::engine_t E;
+        rs2_intrinsics intr{ 640, 480, 100, 200, 50, 70 };
+        rs2_extrinsics extr{ { 1.1, 0.9, 0.2, 0.3, 0.9, 0.7, 0, 0.2, 0.3 },{ 0.1, 0.5, 0.6 } };
+
+        const simd::projection_kernel<E> camera(simd::rigid_transform(extr.rotation, extr.translation),
+            simd::pinhole{ intr.width, intr.height, intr.ppx, intr.ppy, intr.fx, intr.fy });
+
+        for (auto i : ptr)
+        {
+            auto soa = i.gather(i.load(source, F()));
+
+            typename T::gather_type u, v;
+            camera.apply(soa[0], soa[1], soa[2], u, v);
+            i.store(i.scatter(u, v));
+        }
+    }
+};
+
+// Largest difference between float results and their 16-bit encoding,
+// over coordinates that fall inside the frame
+template<class F>
+float max_error(const float* reference, const uint16_t* encoded, size_t count)
+{
+    float result = 0.f;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (reference[i] < 0.f || reference[i] > 1.f) continue;
+        const float diff = std::fabs(reference[i] - F::decode(encoded[i]));
+        if (diff > result) result = diff;
+    }
+    return result;
+}
+
+template<class T, class F>
+void measure_encoded(T& ptr, const float* reference, std::vector<uint16_t>& encoded)
+{
+    test_encoded_app<T, F> app;
+    app.target = encoded.data();
+
+    std::cout << "Output as " << F::name() << ": ";
+    measure([&]()
+    {
+        ptr.apply(app);
+    });
+    std::cout << "Max error of " << F::name() << " (u, v) in frame: " << max_error<F>(reference, encoded.data(), encoded.size()) << std::endl;
+}
+
+// Depth and projected row / column histograms, as the exposure monitor wants them
+template<class E>
+struct frame_histograms
+{
+    simd::histogram<E> z, rows, columns;
+
+    frame_histograms() {}
+    frame_histograms(const rs2_intrinsics& intr)
+        : z(64, 0.f, 5.f), rows(intr.height, 0.f, 1.f), columns(intr.width, 0.f, 1.f)
+    {}
+
+    void merge(const frame_histograms& other)
+    {
+        z.merge(other.z);
+        rows.merge(other.rows);
+        columns.merge(other.columns);
+    }
+};
+
+template<class T>
+struct test_histogram_app
+{
+    frame_histograms<typename T::engine_t> operator()(T& ptr)
+    {
+        typedef typename T::engine_t E;
+        rs2_intrinsics intr{ 640, 480, 100, 200, 50, 70 };
+        rs2_extrinsics extr{ { 1.1, 0.9, 0.2, 0.3, 0.9, 0.7, 0, 0.2, 0.3 },{ 0.1, 0.5, 0.6 } };
+
+        const simd::projection_kernel<E> camera(simd::rigid_transform(extr.rotation, extr.translation),
+            simd::pinhole{ intr.width, intr.height, intr.ppx, intr.ppy, intr.fx, intr.fy });
+        const simd::broadcast<E, float> zero(0.f);
+
+        frame_histograms<E> result(intr);
+        auto z = result.z.make_binner();
+        auto rows = result.rows.make_binner();
+        auto columns = result.columns.make_binner();
+
+        for (auto i : ptr)
+        {
+            auto block = i.load();
+            auto soa = i.gather(block);
+
+            typename T::gather_type u, v;
+            camera.apply(soa[0], soa[1], soa[2], u, v);
+
+            auto valid = soa[2].greater(zero);
+            z.add(soa[2], valid);
+            rows.add(v, valid);
+            columns.add(u, valid);
+        }
+        return result;
+    }
+};
+
+// Normals of an organized point cloud, every block next to its four neighbours
+template<class T>
+struct test_normals_app
+{
+    void operator()(T& ptr)
+    {
+        const simd::normal_kernel<typename T::engine_t> normals;
+        for (auto i : ptr)
+        {
+            typename T::gather_type nx, ny, nz;
+            normals.apply(i.center(), i.up(), i.down(), i.left(), i.right(), nx, ny, nz);
+            i.store(i.scatter(nx, ny, nz));
+        }
+    }
+};
+
+// YUYV macropixels into pairs of RGB pixels
+template<class T>
+struct test_yuyv_app
+{
+    void operator()(T& ptr)
+    {
+        const simd::yuv_kernel<typename T::engine_t> yuv;
+        for (auto i : ptr)
+        {
+            auto yuyv = i.gather(i.load());
+            typename T::gather_type r0, g0, b0, r1, g1, b1;
+            yuv.apply(yuyv[0], yuyv[2], yuyv[1], yuyv[3], r0, g0, b0, r1, g1, b1);
+            i.store(i.scatter(r0, g0, b0, r1, g1, b1));
+        }
+    }
+};
+
+// UYVY macropixels into pairs of opaque RGBA pixels
+template<class T>
+struct test_uyvy_rgba_app
+{
+    void operator()(T& ptr)
+    {
+        const simd::yuv_kernel<typename T::engine_t> yuv;
+        const auto alpha = yuv.template opaque<1>();
+        for (auto i : ptr)
+        {
+            auto uyvy = i.gather(i.load());
+            typename T::gather_type r0, g0, b0, r1, g1, b1;
+            yuv.apply(uyvy[1], uyvy[3], uyvy[0], uyvy[2], r0, g0, b0, r1, g1, b1);
+            i.store(i.scatter(r0, g0, b0, alpha, r1, g1, b1, alpha));
+        }
+    }
+};
+
+// BGR to RGB, nothing but the byte shuffles
+template<class T>
+struct test_bgr_app
+{
+    void operator()(T& ptr)
+    {
+        for (auto i : ptr)
+        {
+            auto bgr = i.gather(i.load());
+            i.store(i.scatter(bgr[2], bgr[1], bgr[0]));
+        }
+    }
+};
+
+// Scalar YUV to RGB, the same BT.601 fixed point arithmetic the kernels use
+static void reference_yuv(int y, int u, int v, uint8_t* rgb)
+{
+    const int luma = (y * 257 * 18997) >> 16;
+    const int r = (luma + 102 * (v - 128) - 1160) >> 6;
+    const int g = (luma - 25 * (u - 128) - 52 * (v - 128) - 1160) >> 6;
+    const int b = (luma + 129 * (u - 128) - 1160) >> 6;
+    rgb[0] = (uint8_t)std::min(std::max(r, 0), 255);
+    rgb[1] = (uint8_t)std::min(std::max(g, 0), 255);
+    rgb[2] = (uint8_t)std::min(std::max(b, 0), 255);
+}
+
+static void reference_yuyv(const uint8_t* yuyv, uint8_t* rgb, size_t pixels)
+{
+    for (size_t i = 0; i < pixels; i += 2, yuyv += 4, rgb += 6)
+    {
+        reference_yuv(yuyv[0], yuyv[1], yuyv[3], rgb);
+        reference_yuv(yuyv[2], yuyv[1], yuyv[3], rgb + 3);
+    }
+}
+
+static void run_color(size_t width, size_t height)
+{
+    const size_t pixels = width * height;
+    std::vector<uint8_t> yuyv(pixels * 2), bgr(pixels * 3);
+    unsigned int seed = 99;
+    for (size_t y = 0; y < height; y++)
+    {
+        for (size_t x = 0; x < width; x++)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            const size_t i = y * width + x;
+            yuyv[i * 2] = (uint8_t)(16 + (x * 219 / width + (seed >> 28)) % 220);
+            yuyv[i * 2 + 1] = (uint8_t)((x & 1) ? 128 + (int)(y * 100 / height) - 50 : (seed >> 24));
+            for (int c = 0; c < 3; c++) bgr[i * 3 + c] = (uint8_t)(seed >> (8 * c));
+        }
+    }
+    std::vector<uint8_t> expected(pixels * 3), rgb(pixels * 3), rgba(pixels * 4);
+    auto mismatches = [&]()
+    {
+        size_t result = 0;
+        for (size_t i = 0; i < expected.size(); i++) result += rgb[i] != expected[i];
+        return result;
+    };
+
+    std::cout << "YUYV to RGB " << width << "x" << height << ", scalar: ";
+    measure([&]()
+    {
+        reference_yuyv(yuyv.data(), expected.data(), pixels);
+    });
+    simd::yuyv_to_rgb<simd::DEFAULT> sse_yuyv(yuyv.data(), rgb.data(), pixels / 2);
+    std::cout << "YUYV to RGB " << width << "x" << height << ", SSE: ";
+    measure([&]()
+    {
+        sse_yuyv.apply(test_yuyv_app<decltype(sse_yuyv)>());
+    });
+    const auto sse_mismatches = mismatches();
+    simd::yuyv_to_rgb<simd::SUPERSPEED> avx_yuyv(yuyv.data(), rgb.data(), pixels / 2);
+    std::cout << "YUYV to RGB " << width << "x" << height << ", AVX: ";
+    measure([&]()
+    {
+        avx_yuyv.apply(test_yuyv_app<decltype(avx_yuyv)>());
+    });
+    const auto avx_mismatches = mismatches();
+
+    // The same bytes read as UYVY: U Y V Y instead of Y U Y V
+    size_t rgba_mismatches = 0;
+    simd::uyvy_to_rgba<simd::SUPERSPEED> avx_uyvy(yuyv.data(), rgba.data(), pixels / 2);
+    std::cout << "UYVY to RGBA " << width << "x" << height << ", AVX: ";
+    measure([&]()
+    {
+        avx_uyvy.apply(test_uyvy_rgba_app<decltype(avx_uyvy)>());
+    });
+    for (size_t i = 0; i < pixels; i += 2)
+    {
+        const uint8_t* m = &yuyv[i * 2];
+        uint8_t pair[6];
+        reference_yuv(m[1], m[0], m[2], pair);
+        reference_yuv(m[3], m[0], m[2], pair + 3);
+        for (int c = 0; c < 3; c++)
+            rgba_mismatches += (rgba[i * 4 + c] != pair[c]) + (rgba[i * 4 + 4 + c] != pair[3 + c]);
+        rgba_mismatches += (rgba[i * 4 + 3] != 255) + (rgba[i * 4 + 7] != 255);
+    }
+
+    std::cout << "BGR to RGB " << width << "x" << height << ", scalar: ";
+    measure([&]()
+    {
+        for (size_t i = 0; i < pixels; i++)
+        {
+            expected[i * 3] = bgr[i * 3 + 2];
+            expected[i * 3 + 1] = bgr[i * 3 + 1];
+            expected[i * 3 + 2] = bgr[i * 3];
+        }
+    });
+    simd::bgr_to_rgb<simd::SUPERSPEED> avx_bgr(bgr.data(), rgb.data(), pixels);
+    std::cout << "BGR to RGB " << width << "x" << height << ", AVX: ";
+    measure([&]()
+    {
+        avx_bgr.apply(test_bgr_app<decltype(avx_bgr)>());
+    });
+    std::cout << "Color mismatches vs scalar: YUYV SSE " << sse_mismatches << ", AVX " << avx_mismatches
+              << ", UYVY RGBA AVX " << rgba_mismatches << ", BGR AVX " << mismatches() << std::endl;
+}
+
+// Scalar reference for the normals, same clamping at the borders
+static void reference_normals(const float3* points, float3* normals, int width, int height)
+{
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            auto at = [&](int r, int c) -> const float3& {
+                return points[std::min(std::max(r, 0), height - 1) * width + std::min(std::max(c, 0), width - 1)];
+            };
+            const float3& up = at(y - 1, x); const float3& down = at(y + 1, x);
+            const float3& left = at(y, x - 1); const float3& right = at(y, x + 1);
+
+            float a[3] = { right.x - left.x, right.y - left.y, right.z - left.z };
+            float b[3] = { down.x - up.x, down.y - up.y, down.z - up.z };
+            float n[3] = { b[1] * a[2] - b[2] * a[1], b[2] * a[0] - b[0] * a[2], b[0] * a[1] - b[1] * a[0] };
+            float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+            float3& out = normals[y * width + x];
+            if (std::min(std::min(std::min(at(y, x).z, up.z), std::min(down.z, left.z)), std::min(right.z, length)) > 0.f)
+                out = { n[0] / length, n[1] / length, n[2] / length };
+            else
+                out = { 0.f, 0.f, 0.f };
+        }
+    }
+}
+
+// Scalar temporal filter, one branch per decision, persistence 2 of the last 3 frames
+struct reference_temporal
+{
+    reference_temporal(size_t count, float alpha, float delta) : last(count), history(count), alpha(alpha), delta(delta) {}
+
+    void apply(const float* depth, float* output)
+    {
+        for (size_t i = 0; i < last.size(); i++)
+        {
+            const float current = depth[i], previous = last[i];
+            const uint8_t h = history[i];
+            float result;
+            if (current > 0.f)
+            {
+                if (previous > 0.f && std::fabs(current - previous) < delta)
+                    result = previous + (current - previous) * alpha;
+                else
+                    result = current;
+            }
+            else
+            {
+                const int valid = (h & 1) + ((h >> 1) & 1) + ((h >> 2) & 1);
+                result = valid >= 2 ? previous : 0.f;
+            }
+            history[i] = (uint8_t)((h << 1) | (current > 0.f ? 1 : 0));
+            output[i] = last[i] = result;
+        }
+    }
+
+    std::vector<float> last;
+    std::vector<uint8_t> history;
+    float alpha, delta;
+};
+
+// Scalar decimation, every N x N block gathered, zeros dropped and the rest sorted
+template<int N>
+static void reference_decimation(const uint16_t* depth, uint16_t* output, size_t width, size_t height, bool median)
+{
+    std::vector<uint16_t> valid;
+    for (size_t y = 0; y < height / N; y++)
+    {
+        for (size_t x = 0; x < width / N; x++)
+        {
+            valid.clear();
+            uint32_t sum = 0;
+            for (int k = 0; k < N; k++)
+                for (int c = 0; c < N; c++)
+                {
+                    const uint16_t d = depth[(y * N + k) * width + x * N + c];
+                    if (d) { valid.push_back(d); sum += d; }
+                }
+            uint16_t& out = output[y * (width / N) + x];
+            if (valid.empty())
+                out = 0;
+            else if (median)
+            {
+                std::sort(valid.begin(), valid.end());
+                out = valid[valid.size() / 2];
+            }
+            else
+                out = (uint16_t)((float)sum / valid.size() + 0.5f);
+        }
+    }
+}
+
+// Float depth through the filter against decimate() block by block, in mismatching pixels
+template<int N, simd::engine_type ET>
+static size_t float_decimation_mismatches(const std::vector<float>& depth, size_t width, size_t height, simd::decimation_mode mode)
+{
+    typedef simd::decimation_filter<N, ET> filter_t;
+    filter_t filter(width, height, mode);
+    std::vector<float> decimated(filter.output_width() * filter.output_height());
+    filter.apply(depth.data(), decimated.data());
+
+    size_t result = 0;
+    float taps[N * N];
+    for (size_t y = 0; y < filter.output_height(); y++)
+    {
+        for (size_t x = 0; x < filter.output_width(); x++)
+        {
+            for (int k = 0; k < N; k++)
+                for (int c = 0; c < N; c++)
+                    taps[k * N + c] = depth[(y * N + k) * width + x * N + c];
+            result += decimated[y * filter.output_width() + x] != filter_t::decimate(taps, mode);
+        }
+    }
+    return result;
+}
+
+template<int N>
+static void run_decimation(const std::vector<uint16_t>& depth, size_t width, size_t height)
+{
+    std::vector<uint16_t> expected((width / N) * (height / N)), decimated(expected.size());
+    simd::decimation_filter<N, simd::DEFAULT> sse_median(width, height);
+    simd::decimation_filter<N, simd::SUPERSPEED> avx_median(width, height), avx_mean(width, height, simd::DECIMATE_MEAN);
+    auto mismatches = [&]()
+    {
+        size_t result = 0;
+        for (size_t i = 0; i < expected.size(); i++) result += decimated[i] != expected[i];
+        return result;
+    };
+
+    std::cout << "Decimation " << N << "x median, scalar: ";
+    measure([&]()
+    {
+        reference_decimation<N>(depth.data(), expected.data(), width, height, true);
+    });
+    std::cout << "Decimation " << N << "x median, SSE: ";
+    measure([&]()
+    {
+        sse_median.apply(depth.data(), decimated.data());
+    });
+    const auto sse_mismatches = mismatches();
+    std::cout << "Decimation " << N << "x median, AVX: ";
+    measure([&]()
+    {
+        avx_median.apply(depth.data(), decimated.data());
+    });
+    const auto avx_mismatches = mismatches();
+    reference_decimation<N>(depth.data(), expected.data(), width, height, false);
+    std::cout << "Decimation " << N << "x mean, AVX: ";
+    measure([&]()
+    {
+        avx_mean.apply(depth.data(), decimated.data());
+    });
+    std::cout << "Decimation " << N << "x mismatches vs scalar: median SSE " << sse_mismatches << ", AVX " << avx_mismatches
+              << ", mean AVX " << mismatches() << " of " << expected.size() << " px" << std::endl;
+
+    // Float depth with every kind of missing tap: 0, negative and NaN are all left out
+    std::vector<float> metric(depth.size());
+    for (size_t i = 0; i < depth.size(); i++)
+        metric[i] = i % 53 == 0 ? -0.5f : i % 71 == 0 ? std::numeric_limits<float>::quiet_NaN() : depth[i] * 0.001f;
+    std::cout << "Decimation " << N << "x with negative and NaN depth, mismatches vs scalar: median SSE "
+              << float_decimation_mismatches<N, simd::DEFAULT>(metric, width, height, simd::DECIMATE_MEDIAN) << ", AVX "
+              << float_decimation_mismatches<N, simd::SUPERSPEED>(metric, width, height, simd::DECIMATE_MEDIAN) << ", mean SSE "
+              << float_decimation_mismatches<N, simd::DEFAULT>(metric, width, height, simd::DECIMATE_MEAN) << ", AVX "
+              << float_decimation_mismatches<N, simd::SUPERSPEED>(metric, width, height, simd::DECIMATE_MEAN) << std::endl;
+}
+
+// Feeds every point with depth to a voxel grid
+template<class T>
+struct test_voxel_app
+{
+    void operator()(T& ptr, simd::voxel_grid<typename T::engine_t>& grid)
+    {
+        auto quantizer = grid.make_quantizer();
+        const simd::broadcast<typename T::engine_t, float> zero(0.f);
+        for (auto i : ptr)
+        {
+            auto xyz = i.gather(i.load());
+            quantizer.add(xyz[0], xyz[1], xyz[2], xyz[2].greater(zero));
+        }
+    }
+};
+
+struct voxel_sum { float x, y, z; unsigned int count; };
+typedef std::vector<std::array<float, 4>> voxel_list;
+
+// Centroids and point counts, sorted, so tables of any order compare equal
+template<class G>
+static voxel_list voxel_centroids(const G& grid)
+{
+    std::vector<float> xyz(grid.size() * 3);
+    std::vector<unsigned int> counts(grid.size());
+    grid.centroids(xyz.data(), counts.data());
+    voxel_list result(grid.size());
+    for (size_t i = 0; i < grid.size(); i++)
+        result[i] = { { xyz[i * 3], xyz[i * 3 + 1], xyz[i * 3 + 2], (float)counts[i] } };
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+static void run_voxel_grid(const std::vector<float3>& cloud, float voxel_size)
+{
+    typedef simd::voxel_grid<simd::engine<simd::NAIVE>> reference_grid;
+    float3* points = const_cast<float3*>(cloud.data());
+
+    std::unordered_map<uint64_t, voxel_sum> map;
+    std::cout << "Voxel grid " << voxel_size << " m, unordered_map: ";
+    measure([&]()
+    {
+        map.clear();
+        for (auto&& p : cloud)
+        {
+            if (!(p.z > 0.f)) continue;
+            auto& v = map[reference_grid::key(p.x, p.y, p.z, 1.f / voxel_size)];
+            v.x += p.x; v.y += p.y; v.z += p.z;
+            v.count++;
+        }
+    });
+    voxel_list expected;
+    for (auto&& v : map)
+        expected.push_back({ { v.second.x / v.second.count, v.second.y / v.second.count, v.second.z / v.second.count, (float)v.second.count } });
+    std::sort(expected.begin(), expected.end());
+
+    simd::transformation<float, float3, float, float3, simd::DEFAULT> sse_points(&points->x, &points->x, cloud.size());
+    simd::voxel_grid<decltype(sse_points)::engine_t> sse_grid(voxel_size);
+    std::cout << "Voxel grid " << voxel_size << " m, SSE: ";
+    measure([&]()
+    {
+        sse_grid.clear();
+        test_voxel_app<decltype(sse_points)>()(sse_points, sse_grid);
+    });
+
+    simd::transformation<float, float3, float, float3, simd::SUPERSPEED> avx_points(&points->x, &points->x, cloud.size());
+    simd::voxel_grid<decltype(avx_points)::engine_t> avx_grid(voxel_size);
+    std::cout << "Voxel grid " << voxel_size << " m, AVX: ";
+    measure([&]()
+    {
+        avx_grid.clear();
+        test_voxel_app<decltype(avx_points)>()(avx_points, avx_grid);
+    });
+
+    decltype(avx_grid) parallel_grid;
+    std::cout << "Voxel grid " << voxel_size << " m, AVX, 4 threads: ";
+    measure([&]()
+    {
+        parallel_grid = simd::parallel_voxelize(avx_points, voxel_size, test_voxel_app<decltype(avx_points)>(), 4);
+    });
+
+    std::cout << "Voxel grid " << voxel_size << " m: " << expected.size() << " voxels, matching unordered_map: SSE "
+              << (voxel_centroids(sse_grid) == expected) << ", AVX " << (voxel_centroids(avx_grid) == expected)
+              << ", AVX 4 threads " << (voxel_centroids(parallel_grid) == expected) << std::endl;
+}
+
+// The same slices, each run by a worker of the next node, so that every worker reads
+// and writes pages first touched on another node
+static std::vector<simd::numa_slice> remote_plan(std::vector<simd::numa_slice> plan, const simd::numa_topology& topology)
+{
+    std::vector<size_t> used(topology.nodes(), 0);
+    for (auto&& s : plan)
+    {
+        s.node = (s.node + 1) % topology.nodes();
+        const auto& cpus = topology.cpus(s.node);
+        s.cpu = cpus[used[s.node]++ % cpus.size()];
+    }
+    return plan;
+}
+
+static std::vector<char> read_bytes(char const* filename)
+{
+    std::ifstream ifs(filename, std::ios::binary | std::ios::ate);
+    std::ifstream::pos_type pos = ifs.tellg();
+
+    std::vector<char> result(pos);
+
+    ifs.seekg(0, std::ios::beg);
+    ifs.read(&result[0], pos);
+
+    return result;
+}
+
+// Pinhole projection alone, for points already in the camera's frame
+template<class T>
+struct test_pinhole_app
+{
+    simd::pinhole camera;
+
+    void operator()(T& ptr)
+    {
+        const simd::projection_kernel<typename T::engine_t> kernel(simd::rigid_transform(), camera);
+        for (auto i : ptr)
+        {
+            auto soa = i.gather(i.load());
+            typename T::gather_type u, v;
+            kernel.apply(soa[0], soa[1], soa[2], u, v);
+            i.store(i.scatter(u, v));
+        }
+    }
+};
+
+// Buffers of every stage of the pipeline, reused from frame to frame
+struct frame
+{
+    std::vector<float> depth;
+    std::vector<float3> points, reframed;
+    std::vector<float2> uv;
+    std::vector<uint8_t> samples;
+};
+
+// decode -> deproject -> transform -> project -> sample: depth of the recording into
+// points, into the second camera's frame, onto its image and the image value there
+class pipeline_chain
+{
+public:
+    typedef simd::transformation<float, float3, float, float3, simd::SUPERSPEED> reframe_t;
+    typedef simd::transformation<float, float3, float, float2, simd::SUPERSPEED> project_t;
+
+    pipeline_chain(const std::vector<char>& recording)
+        : _recording((const float3*)recording.data()), _count(recording.size() / sizeof(float3)),
+          _depth_camera{ 640, 480, 321.5f, 238.7f, 383.2f, 383.9f }, _color_camera{ 640, 480, 318.2f, 242.1f, 610.4f, 611.0f },
+          _image(640 * 480)
+    {
+        _rays.update(_depth_camera);
+        for (size_t i = 0; i < _image.size(); i++) _image[i] = (uint8_t)(i * 7 + i / 640);
+    }
+
+    void allocate(frame& f) const
+    {
+        f.depth.resize(_count);
+        f.points.resize(_count);
+        f.reframed.resize(_count);
+        f.uv.resize(_count);
+        f.samples.resize(_count);
+    }
+
+    void decode(frame& f) const
+    {
+        for (size_t i = 0; i < _count; i++) f.depth[i] = _recording[i].z;
+    }
+    void deproject(frame& f)
+    {
+        _rays.deproject(f.depth.data(), f.points.data());
+    }
+    void transform(frame& f)
+    {
+        _reframe.bind(&f.points[0].x, &f.reframed[0].x, _count);
+        _reframe.apply(test_reframe_app<reframe_t>());
+    }
+    void project(frame& f)
+    {
+        _project.bind(&f.reframed[0].x, &f.uv[0].x, _count);
+        _project.apply(test_pinhole_app<project_t>{ _color_camera });
+    }
+    void sample(frame& f) const
+    {
+        for (size_t i = 0; i < _count; i++)
+        {
+            const float u = f.uv[i].x * _color_camera.width, v = f.uv[i].y * _color_camera.height;
+            const bool inside = u >= 0.f && v >= 0.f && u < _color_camera.width && v < _color_camera.height;
+            f.samples[i] = inside ? _image[(size_t)v * 640 + (size_t)u] : 0;
+        }
+    }
+
+    void run(frame& f)
+    {
+        decode(f);
+        deproject(f);
+        transform(f);
+        project(f);
+        sample(f);
+    }
 
-            auto u1 = to_point_x / to_point_z, v1 = to_point_y / to_point_z;
+private:
+    const float3* _recording;
+    size_t _count;
+    simd::pinhole _depth_camera, _color_camera;
+    std::vector<uint8_t> _image;
+    simd::ray_cache<simd::SUPERSPEED> _rays;
+    reframe_t _reframe;
+    project_t _project;
+};
 
+static void run_pipeline(const std::vector<char>& recording)
+{
+    using namespace simd;
+    const auto frames_count = 30;
 
-            auto px = u1 * intr.fx + intr.ppx;
-            auto py = v1 * intr.fy + intr.ppy;
+    // Each stage gets a chain of its own, stages run concurrently
+    pipeline_chain decoder(recording), deprojector(recording), transformer(recording), projector(recording), sampler(recording);
 
-            auto u = px / (intr.width);
-            auto v = py / (intr.height);
+    pipeline_chain sequential(recording);
+    frame expected;
+    sequential.allocate(expected);
+    sequential.run(expected);
 
-            auto out_block = i.scatter(u, v);
-            //auto out_block = i.scatter(x, y);
-            i.store(out_block);
-        }
-    }
-};
+    std::vector<frame> frames(4);
+    for (auto&& f : frames) sequential.allocate(f);
 
-static std::vector<char> read_bytes(char const* filename)
-{
-    std::ifstream ifs(filename, std::ios::binary | std::ios::ate);
-    std::ifstream::pos_type pos = ifs.tellg();
+    frame_pipeline<frame> pipeline;
+    pipeline.add_stage("decode", [&](frame& f) { decoder.decode(f); });
+    pipeline.add_stage("deproject", [&](frame& f) { deprojector.deproject(f); });
+    pipeline.add_stage("transform", [&](frame& f) { transformer.transform(f); });
+    pipeline.add_stage("project", [&](frame& f) { projector.project(f); });
+    pipeline.add_stage("sample", [&](frame& f) { sampler.sample(f); });
+    pipeline.start();
 
-    std::vector<char> result(pos);
+    auto start = std::chrono::high_resolution_clock::now();
+    int submitted = 0, completed = 0, matching = 0;
+    size_t next_free = 0;
+    while (completed < frames_count)
+    {
+        frame* f;
+        if (submitted - completed < (int)frames.size() && submitted < frames_count)
+        {
+            if (pipeline.submit(&frames[next_free])) { next_free = (next_free + 1) % frames.size(); submitted++; }
+            if (!pipeline.receive(f)) continue;
+        }
+        else if (!pipeline.receive(f, std::chrono::milliseconds(100))) continue;
+        completed++;
+        matching += f->samples == expected.samples && f->depth == expected.depth;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    pipeline.stop();
 
-    ifs.seekg(0, std::ios::beg);
-    ifs.read(&result[0], pos);
+    auto diff = std::chrono::duration<double, std::micro>(end - start).count() / frames_count;
+    std::cout << "Pipeline: " << diff << " micro per frame, " << matching << "/" << frames_count
+              << " frames match the sequential chain, "
+              << std::count_if(expected.samples.begin(), expected.samples.end(), [](uint8_t v) { return v != 0; })
+              << " points sampled per frame" << std::endl;
+    pipeline.print(std::cout);
 
-    return result;
+    // Frames left in the output ring, nobody receiving: stop() drops what does not fit
+    frame_pipeline<frame, 2> abandoned;
+    abandoned.add_stage("decode", [&](frame& f) { decoder.decode(f); });
+    abandoned.start();
+    for (auto&& f : frames) while (!abandoned.submit(&f)) std::this_thread::yield();
+    abandoned.stop();
+    std::cout << "Pipeline stopped with nobody receiving: " << abandoned.stats()[0].frames << " frames decoded, "
+              << abandoned.stats()[0].dropped << " dropped" << std::endl;
 }
 
 int main()
@@ -175,6 +1110,924 @@ int main()
     }
     std::cout << std::endl;
 
+    // Register blocking: 2 and 4 AVX registers per variable, spill warning in print()
+    transformation<float, float3, float, float2, SUPERSPEED, 2> blocked2_ptr((float*)input.data(), (float*)output.data(), input_size);
+    transformation<float, float3, float, float2, SUPERSPEED, 4> blocked4_ptr((float*)input.data(), (float*)output.data(), input_size);
+
+    std::cout << "Blocking 2: ";
+    measure([&]()
+    {
+        blocked2_ptr.apply(test_app<decltype(blocked2_ptr)>());
+    });
+    std::cout << "Blocking 4: ";
+    measure([&]()
+    {
+        blocked4_ptr.apply(test_app<decltype(blocked4_ptr)>());
+    });
+    blocked4_ptr.print(std::cout);
+    {
+        simd_ptr3.apply(test_app<decltype(simd_ptr3)>());
+        const std::vector<float2> unblocked(output_ptr, output_ptr + input_size);
+        auto blocked_mismatches = [&](size_t covered)
+        {
+            size_t result = covered == input_size ? 0 : input_size - covered;
+            for (size_t i = 0; i < covered; i++)
+                result += output_ptr[i].x != unblocked[i].x || output_ptr[i].y != unblocked[i].y;
+            return result;
+        };
+        blocked2_ptr.apply(test_app<decltype(blocked2_ptr)>());
+        const auto blocked2_mismatches = blocked_mismatches(blocked2_ptr.size());
+        blocked4_ptr.apply(test_app<decltype(blocked4_ptr)>());
+        std::cout << "Blocking vs U=1 mismatches: 2 -> " << blocked2_mismatches << ", 4 -> "
+                  << blocked_mismatches(blocked4_ptr.size()) << std::endl;
+    }
+
+    // Same projection picked at runtime through the C registry
+    {
+        rs2_intrinsics intr{ 640, 480, 100, 200, 50, 70 };
+        rs2_extrinsics extr{ { 1.1, 0.9, 0.2, 0.3, 0.9, 0.7, 0, 0.2, 0.3 },{ 0.1, 0.5, 0.6 } };
+        simd_parameters params;
+        std::copy(extr.rotation, extr.rotation + 9, params.rotation);
+        std::copy(extr.translation, extr.translation + 3, params.translation);
+        params.width = intr.width; params.height = intr.height;
+        params.ppx = intr.ppx; params.ppy = intr.ppy;
+        params.fx = intr.fx; params.fy = intr.fy;
+
+        std::vector<float> expected((float*)output.data(), (float*)output.data() + input_size * 2);
+        const simd_kernel project = simd_find_kernel(SIMD_OP_PROJECT, SIMD_LAYOUT_AOS, SIMD_LAYOUT_AOS, SIMD_ENGINE_BEST);
+
+        std::cout << "Registry, " << simd_engine_name(SIMD_ENGINE_BEST) << " kernel: ";
+        measure([&]()
+        {
+            project(&params, (const float*)input.data(), (float*)output.data(), input_size);
+        });
+        float difference = 0.f;
+        for (size_t i = 0; i < expected.size(); i++)
+            if (expected[i] >= 0.f && expected[i] <= 1.f)
+                difference = std::max(difference, std::fabs(expected[i] - ((float*)output.data())[i]));
+        std::cout << "Registry max difference (u, v) in frame: " << difference << std::endl;
+
+        // Every kernel of every other engine the CPU runs, forced by id, against the naive
+        // one of the same key. The SoA kernels read the same frame as x[] y[] z[].
+        const simd_operation operations[] = { SIMD_OP_RIGID_TRANSFORM, SIMD_OP_PROJECT };
+        const simd_layout layouts[] = { SIMD_LAYOUT_AOS, SIMD_LAYOUT_SOA };
+        const simd_engine engines[] = { SIMD_ENGINE_DEFAULT, SIMD_ENGINE_SUPERSPEED };
+        std::vector<float> reference(input_size * 3), forced(input_size * 3);
+        for (auto engine : engines)
+        {
+            size_t kernels = 0, mismatches = 0;
+            for (auto op : operations)
+                for (auto in : layouts)
+                    for (auto out : layouts)
+                    {
+                        const simd_kernel naive_kernel = simd_find_kernel(op, in, out, SIMD_ENGINE_NAIVE);
+                        const simd_kernel kernel = simd_find_kernel(op, in, out, engine);
+                        if (!kernel) continue;
+                        naive_kernel(&params, (const float*)input.data(), reference.data(), input_size);
+                        kernel(&params, (const float*)input.data(), forced.data(), input_size);
+                        kernels++;
+                        const size_t scalars = input_size * (op == SIMD_OP_PROJECT ? 2 : 3);
+                        for (size_t i = 0; i < scalars; i++)
+                        {
+                            // (u, v) inside the frame only, FMA rounding of a z near 0 is amplified outside it
+                            const bool compared = op == SIMD_OP_PROJECT ? reference[i] >= 0.f && reference[i] <= 1.f : std::isfinite(reference[i]);
+                            if (compared) mismatches += std::fabs(forced[i] - reference[i]) > 1e-4f * std::max(1.f, std::fabs(reference[i]));
+                        }
+                    }
+            if (kernels)
+                std::cout << "Registry " << simd_engine_name(engine) << " vs naive: " << kernels << " kernels, "
+                          << mismatches << " mismatches" << std::endl;
+            else
+                std::cout << "Registry " << simd_engine_name(engine) << ": not supported by this CPU" << std::endl;
+        }
+    }
+
+    // Same projection over planar x[] y[] z[] -> u[] v[], without gather / scatter shuffles
+    std::vector<float> planar_in(input_size * 3), planar_out(input_size * 2);
+    for (size_t i = 0; i < input_size; i++)
+    {
+        planar_in[i] = input_ptr[i].x;
+        planar_in[input_size + i] = input_ptr[i].y;
+        planar_in[2 * input_size + i] = input_ptr[i].z;
+    }
+    transformation<float, soa<float3>, float, soa<float2>, SUPERSPEED> planar_ptr(planar_in.data(), planar_out.data(), input_size);
+
+    std::cout << "SoA in, SoA out: ";
+    measure([&]()
+    {
+        planar_ptr.apply(test_app<decltype(planar_ptr)>());
+    });
+    simd_ptr3.apply(test_app<decltype(simd_ptr3)>());
+    size_t planar_mismatches = 0;
+    for (size_t i = 0; i < input_size; i++)
+        planar_mismatches += planar_out[i] != output_ptr[i].x || planar_out[input_size + i] != output_ptr[i].y;
+    std::cout << "SoA vs AoS mismatches: " << planar_mismatches << std::endl;
+
+    // Positions inside 32-byte vertex records, no copying positions out first
+    std::vector<vertex> vertices(input_size);
+    for (size_t i = 0; i < input_size; i++) vertices[i].position = input_ptr[i];
+    transformation<float, strided<float3, sizeof(vertex), 0>, float, float2, SUPERSPEED> vertex_ptr((float*)vertices.data(), (float*)output.data(), input_size);
+    transformation<float, strided<float3>, float, float2, SUPERSPEED> runtime_vertex_ptr((float*)vertices.data(), (float*)output.data(), input_size);
+    runtime_vertex_ptr.set_input_stride(sizeof(vertex), 0);
+
+    std::cout << "Strided vertices: ";
+    measure([&]()
+    {
+        vertex_ptr.apply(test_app<decltype(vertex_ptr)>());
+    });
+    std::cout << "Strided vertices, runtime stride: ";
+    measure([&]()
+    {
+        runtime_vertex_ptr.apply(test_app<decltype(runtime_vertex_ptr)>());
+    });
+
+    // Strided reads against the AoS projection of the same points, and five-float records,
+    // wider than one SSE transpose, against the same records packed
+    {
+        simd_ptr3.apply(test_app<decltype(simd_ptr3)>());
+        const std::vector<float2> aos_uv(output_ptr, output_ptr + input_size);
+        auto uv_mismatches = [&]()
+        {
+            size_t result = 0;
+            for (size_t i = 0; i < input_size; i++)
+                result += output_ptr[i].x != aos_uv[i].x || output_ptr[i].y != aos_uv[i].y;
+            return result;
+        };
+        vertex_ptr.apply(test_app<decltype(vertex_ptr)>());
+        const auto fixed_mismatches = uv_mismatches();
+        runtime_vertex_ptr.apply(test_app<decltype(runtime_vertex_ptr)>());
+        const auto runtime_mismatches = uv_mismatches();
+        // Next frame: a new bind() keeps the runtime stride
+        runtime_vertex_ptr.bind((float*)vertices.data(), (float*)output.data(), input_size);
+        runtime_vertex_ptr.apply(test_app<decltype(runtime_vertex_ptr)>());
+        const auto rebound_mismatches = uv_mismatches();
+        // Bound through spans, the last record cut right after the 4 floats the transpose reads
+        transformation<float, strided<float3, sizeof(vertex), 0>, float, float2, SUPERSPEED> span_vertex_ptr(
+            span<float>((float*)vertices.data(), (input_size - 1) * sizeof(vertex) / sizeof(float) + 4),
+            span<float>((float*)output.data(), input_size * 2));
+        span_vertex_ptr.apply(test_app<decltype(span_vertex_ptr)>());
+        const auto span_mismatches = uv_mismatches() + input_size - span_vertex_ptr.size();
+
+        std::vector<float5> packed(input_size);
+        std::vector<padded_float5> records(input_size);
+        for (size_t i = 0; i < input_size; i++)
+        {
+            const float3& p = input_ptr[i];
+            packed[i] = { p.x, p.y, p.z, p.x * p.y, (float)i };
+            records[i].value = packed[i];
+        }
+        std::vector<float2> expected(input_size), wide(input_size);
+        transformation<float, float5, float, float2, DEFAULT> packed_ptr(&packed[0].x, &expected[0].x, input_size);
+        packed_ptr.apply(test_components_app<decltype(packed_ptr)>());
+        auto wide_mismatches = [&]()
+        {
+            size_t result = 0;
+            for (size_t i = 0; i < input_size; i++)
+                result += wide[i].x != expected[i].x || wide[i].y != expected[i].y;
+            return result;
+        };
+        transformation<float, strided<float5, sizeof(padded_float5), 0>, float, float2, DEFAULT> sse_wide(&records[0].value.x, &wide[0].x, input_size);
+        sse_wide.apply(test_components_app<decltype(sse_wide)>());
+        const auto sse_fixed = wide_mismatches();
+        transformation<float, strided<float5>, float, float2, DEFAULT> sse_runtime_wide(&records[0].value.x, &wide[0].x, input_size);
+        sse_runtime_wide.set_input_stride(sizeof(padded_float5), 0);
+        sse_runtime_wide.apply(test_components_app<decltype(sse_runtime_wide)>());
+        const auto sse_runtime = wide_mismatches();
+        transformation<float, strided<float5>, float, float2, SUPERSPEED> avx_runtime_wide(&records[0].value.x, &wide[0].x, input_size);
+        avx_runtime_wide.set_input_stride(sizeof(padded_float5), 0);
+        avx_runtime_wide.apply(test_components_app<decltype(avx_runtime_wide)>());
+
+        std::cout << "Strided vs AoS mismatches: vertices " << fixed_mismatches << ", runtime stride " << runtime_mismatches
+                  << ", re-bound " << rebound_mismatches
+                  << ", bound through spans " << span_mismatches
+                  << "; five-float records SSE " << sse_fixed << ", SSE runtime stride " << sse_runtime
+                  << ", AVX runtime stride " << wide_mismatches() << std::endl;
+    }
+
+    // Extrinsics alone, into a second buffer and over the input itself
+    std::vector<float> reframed(input_size * 3), reframed_in_place(input_size * 3);
+    transformation<float, float3, float, float3, SUPERSPEED> reframe_ptr((float*)input.data(), reframed.data(), input_size);
+    transformation<float, float3, float, float3, SUPERSPEED> in_place_ptr(reframed_in_place.data(), input_size);
+
+    std::cout << "Re-frame, separate output: ";
+    measure([&]()
+    {
+        reframe_ptr.apply(test_reframe_app<decltype(reframe_ptr)>());
+    });
+    std::cout << "Re-frame, in place (incl. restoring the input): ";
+    measure([&]()
+    {
+        std::copy((float*)input.data(), (float*)input.data() + input_size * 3, reframed_in_place.begin());
+        in_place_ptr.apply(test_reframe_app<decltype(in_place_ptr)>());
+    });
+    std::cout << "In place matches: " << (reframed == reframed_in_place ? "yes" : "no") << std::endl;
+
+    // Re-framed points recorded as binary PLY / PCD, per-point ostream writes vs the
+    // output blocks handed to writev() as they are
+    {
+        std::cout << "Record PLY, ostream per point: ";
+        measure([&]()
+        {
+            std::ofstream file("reframed_ostream.ply", std::ios::binary);
+            file << "ply\nformat binary_little_endian 1.0\nelement vertex " << input_size
+                 << "\nproperty float x\nproperty float y\nproperty float z\nend_header\n";
+            for (size_t i = 0; i < input_size; i++)
+                file.write((const char*)&reframed[i * 3], sizeof(float3));
+        });
+        std::cout << "Record PLY, writer: ";
+        measure([&]()
+        {
+            point_cloud_writer writer("reframed.ply", PLY_BINARY, cloud_layout::xyz());
+            writer.write(reframe_ptr);
+        });
+        std::cout << "Record PCD, writer, 4 slices: ";
+        measure([&]()
+        {
+            point_cloud_writer writer("reframed.pcd", PCD_BINARY, cloud_layout::xyz());
+            const auto quarter = reframe_ptr.blocks() / 4;
+            for (size_t s = 0; s < 4; s++)
+                writer.write(reframe_ptr.slice(s * quarter, s == 3 ? reframe_ptr.blocks() - 3 * quarter : quarter));
+        });
+
+        const auto recorded = read_bytes("reframed.ply");
+        const auto header_end = std::string(recorded.begin(), recorded.end()).find("end_header\n") + 11;
+        const auto pcd = read_bytes("reframed.pcd");
+        const auto data_start = std::string(pcd.begin(), pcd.end()).find("DATA binary\n") + 12;
+        const bool ply_matches = recorded.size() == header_end + input_size * sizeof(float3) &&
+            std::equal(recorded.begin() + header_end, recorded.end(), (const char*)reframed.data());
+        const bool pcd_matches = pcd.size() == data_start + input_size * sizeof(float3) &&
+            std::equal(pcd.begin() + data_start, pcd.end(), (const char*)reframed.data());
+        std::cout << "Recorded points match: PLY " << (ply_matches ? "yes" : "no")
+                  << ", PCD " << (pcd_matches ? "yes" : "no") << std::endl;
+        std::remove("reframed_ostream.ply");
+        std::remove("reframed.ply");
+        std::remove("reframed.pcd");
+    }
+
+    // Extrinsics -> extrinsics -> projection over a 1080p frame, tile by tile vs pass by pass
+    {
+        typedef transformation<float, float3, float, float3, SUPERSPEED> reframe_t;
+        typedef transformation<float, float3, float, float2, SUPERSPEED> project_t;
+        auto chain = make_tiled_chain(
+            make_stage<reframe_t>(test_reframe_app<reframe_t>()),
+            make_stage<reframe_t>(test_reframe_app<reframe_t>()),
+            make_stage<project_t>(test_app<project_t>()));
+
+        const size_t full_hd = 1920 * 1080;
+        std::vector<float> points(full_hd * 3), tiled_out(full_hd * 2), by_pass_out(full_hd * 2);
+        for (size_t i = 0; i < points.size(); i++) points[i] = ((float*)input.data())[i % (input_size * 3)];
+
+        std::cout << "Chain tile: " << chain.tile() << " elements (L1 " << cache_size(1) / 1024
+                  << "K, L2 " << cache_size(2) / 1024 << "K)" << std::endl;
+        std::cout << "Chain, pass by pass: ";
+        measure([&]()
+        {
+            chain.apply_by_pass(points.data(), by_pass_out.data(), full_hd);
+        });
+        std::cout << "Chain, tiled: ";
+        measure([&]()
+        {
+            chain.apply(points.data(), tiled_out.data(), full_hd);
+        });
+        std::cout << "Chain, tiled vs pass by pass results match: " << (tiled_out == by_pass_out ? "yes" : "no") << std::endl;
+
+        // Runtime-stride vertices as the first stage, against the same chain over packed points
+        typedef transformation<float, strided<float3>, float, float3, SUPERSPEED> vertex_reframe_t;
+        auto vertex_stage = make_stage<vertex_reframe_t>(test_reframe_app<vertex_reframe_t>());
+        vertex_stage.transformation.set_input_stride(sizeof(vertex), 0);
+        auto vertex_chain = make_tiled_chain(vertex_stage, make_stage<project_t>(test_app<project_t>()));
+        auto packed_chain = make_tiled_chain(make_stage<reframe_t>(test_reframe_app<reframe_t>()),
+                                             make_stage<project_t>(test_app<project_t>()));
+        std::vector<float> vertex_out(input_size * 2), packed_out(input_size * 2);
+        vertex_chain.apply((float*)vertices.data(), vertex_out.data(), input_size);
+        packed_chain.apply((float*)input.data(), packed_out.data(), input_size);
+        std::cout << "Chain over runtime-stride vertices matches packed points: " << (vertex_out == packed_out ? "yes" : "no") << std::endl;
+    }
+
+    // Double precision projection, against the float result and a scalar double reference
+    {
+        std::vector<double> points(input_size * 3), projected(input_size * 2), expected(input_size * 2);
+        for (size_t i = 0; i < points.size(); i++) points[i] = ((float*)input.data())[i];
+        transformation<double, double3, double, double2, DEFAULT> double_ptr2(points.data(), projected.data(), input_size);
+        transformation<double, double3, double, double2, SUPERSPEED> double_ptr3(points.data(), projected.data(), input_size);
+
+        rs2_intrinsics intr{ 640, 480, 100, 200, 50, 70 };
+        rs2_extrinsics extr{ { 1.1, 0.9, 0.2, 0.3, 0.9, 0.7, 0, 0.2, 0.3 },{ 0.1, 0.5, 0.6 } };
+        std::cout << "Scalar double: ";
+        measure([&]()
+        {
+            for (size_t i = 0; i < input_size; i++)
+            {
+                const double* xyz = &points[i * 3];
+                double p[3];
+                for (int k = 0; k < 3; k++)
+                    p[k] = xyz[0] * (double)extr.rotation[k] + xyz[1] * (double)extr.rotation[k + 3] +
+                           xyz[2] * (double)extr.rotation[k + 6] + (double)extr.translation[k];
+                expected[i * 2] = (p[0] / p[2] * (double)intr.fx + (double)intr.ppx) / (double)intr.width;
+                expected[i * 2 + 1] = (p[1] / p[2] * (double)intr.fy + (double)intr.ppy) / (double)intr.height;
+            }
+        });
+
+        simd_ptr3.apply(test_app<decltype(simd_ptr3)>());
+        double float_error = 0, sse_error = 0, avx_error = 0;
+        for (size_t i = 0; i < expected.size(); i++)
+            if (expected[i] >= 0 && expected[i] <= 1) float_error = std::max(float_error, std::fabs(expected[i] - ((float*)output.data())[i]));
+
+        std::cout << "SSE double: ";
+        measure([&]()
+        {
+            double_ptr2.apply(test_double_app<decltype(double_ptr2)>());
+        });
+        for (size_t i = 0; i < expected.size(); i++)
+            if (expected[i] >= 0 && expected[i] <= 1) sse_error = std::max(sse_error, std::fabs(expected[i] - projected[i]));
+
+        std::cout << "AVX double: ";
+        measure([&]()
+        {
+            double_ptr3.apply(test_double_app<decltype(double_ptr3)>());
+        });
+        for (size_t i = 0; i < expected.size(); i++)
+            if (expected[i] >= 0 && expected[i] <= 1) avx_error = std::max(avx_error, std::fabs(expected[i] - projected[i]));
+
+        std::cout << "Max error in frame vs scalar double: float " << float_error << ", SSE double " << sse_error
+                  << ", AVX double " << avx_error << std::endl;
+    }
+
+    // Normals over a 640x480 wavy surface with a few holes, vs the scalar reference
+    {
+        const int width = 640, height = 480;
+        std::vector<float3> organized(width * height), expected(width * height), normals(width * height);
+        for (int y = 0; y < height; y++)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                const float z = (x * 31 + y * 17) % 97 ? 2.f + 0.2f * std::sin(x * 0.05f) * std::cos(y * 0.03f) : 0.f;
+                organized[y * width + x] = { (x - 320.f) / 500.f * z, (y - 240.f) / 500.f * z, z };
+            }
+        }
+
+        std::cout << "Normals, scalar: ";
+        measure([&]()
+        {
+            reference_normals(organized.data(), expected.data(), width, height);
+        });
+
+        stencil_transformation<float, float3, float, float3, DEFAULT> sse_normals(&organized[0].x, &normals[0].x, width, height);
+        stencil_transformation<float, float3, float, float3, SUPERSPEED> avx_normals(&organized[0].x, &normals[0].x, width, height);
+        auto normals_error = [&]()
+        {
+            float error = 0.f;
+            for (size_t i = 0; i < normals.size(); i++)
+                error = std::max(error, std::max(std::fabs(normals[i].x - expected[i].x),
+                                 std::max(std::fabs(normals[i].y - expected[i].y), std::fabs(normals[i].z - expected[i].z))));
+            return error;
+        };
+
+        std::cout << "Normals, SSE stencil: ";
+        measure([&]()
+        {
+            sse_normals.apply(test_normals_app<decltype(sse_normals)>());
+        });
+        const auto sse_error = normals_error();
+        std::cout << "Normals, AVX stencil: ";
+        measure([&]()
+        {
+            avx_normals.apply(test_normals_app<decltype(avx_normals)>());
+        });
+        std::cout << "Normals max error: SSE " << sse_error << ", AVX " << normals_error() << "  center normal: ("
+                  << normals[240 * width + 320].x << ", " << normals[240 * width + 320].y << ", "
+                  << normals[240 * width + 320].z << ")" << std::endl;
+    }
+
+    // Temporal filter over noisy depth frames with dropouts, same 8 frames in a loop
+    {
+        const size_t pixels = input_size;
+        const int frame_count = 8;
+        std::vector<float> truth(pixels);
+        for (size_t i = 0; i < pixels; i++) truth[i] = ((float*)input.data())[i * 3 + 2];
+        std::vector<std::vector<float>> frames(frame_count, truth);
+        unsigned int seed = 12345;
+        for (auto&& f : frames)
+        {
+            for (auto&& z : f)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                z = (seed >> 24) < 26 ? 0.f : z + ((int)((seed >> 8) % 1000) - 500) * 0.00002f;
+            }
+        }
+
+        std::vector<float> filtered(pixels), expected(pixels);
+        reference_temporal scalar_filter(pixels, 0.4f, 0.02f);
+        temporal_filter<DEFAULT> sse_filter(pixels);
+        temporal_filter<SUPERSPEED> avx_filter(pixels);
+
+        int frame = 0;
+        std::cout << "Temporal filter, scalar: ";
+        measure([&]()
+        {
+            scalar_filter.apply(frames[frame++ % frame_count].data(), expected.data());
+        });
+        frame = 0;
+        std::cout << "Temporal filter, SSE: ";
+        measure([&]()
+        {
+            sse_filter.apply(frames[frame++ % frame_count].data(), filtered.data());
+        });
+        float sse_difference = 0.f;
+        for (size_t i = 0; i < pixels; i++) sse_difference = std::max(sse_difference, std::fabs(filtered[i] - expected[i]));
+        frame = 0;
+        std::cout << "Temporal filter, AVX: ";
+        measure([&]()
+        {
+            avx_filter.apply(frames[frame++ % frame_count].data(), filtered.data());
+        });
+        float avx_difference = 0.f;
+        double raw_error = 0, filtered_error = 0;
+        size_t raw_valid = 0, filtered_valid = 0;
+        for (size_t i = 0; i < pixels; i++)
+        {
+            avx_difference = std::max(avx_difference, std::fabs(filtered[i] - expected[i]));
+            const float raw = frames[(frame - 1) % frame_count][i];
+            if (raw > 0.f) { raw_error += (raw - truth[i]) * (raw - truth[i]); raw_valid++; }
+            if (filtered[i] > 0.f) { filtered_error += (filtered[i] - truth[i]) * (filtered[i] - truth[i]); filtered_valid++; }
+        }
+        std::cout << "Temporal filter vs scalar: SSE " << sse_difference << ", AVX " << avx_difference
+                  << "  RMS error raw " << std::sqrt(raw_error / raw_valid) << " (" << raw_valid << " px), filtered "
+                  << std::sqrt(filtered_error / filtered_valid) << " (" << filtered_valid << " px)" << std::endl;
+    }
+
+    // Decimation of a 1280x720 depth frame in millimeters, with noise and dropouts
+    {
+        const size_t width = 1280, height = 720;
+        std::vector<uint16_t> depth(width * height);
+        unsigned int seed = 777;
+        for (size_t y = 0; y < height; y++)
+        {
+            for (size_t x = 0; x < width; x++)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                const float z = 1500.f + 400.f * std::sin(x * 0.01f) * std::cos(y * 0.013f) + ((int)((seed >> 8) % 41) - 20);
+                depth[y * width + x] = (seed >> 24) < 26 ? 0 : (uint16_t)z;
+            }
+        }
+        run_decimation<2>(depth, width, height);
+        run_decimation<3>(depth, width, height);
+        run_decimation<4>(depth, width, height);
+    }
+
+    // Packed color conversions, 720p and 1080p frames
+    run_color(1280, 720);
+    run_color(1920, 1080);
+
+    // Frames submitted to a worker pool while earlier ones are still being projected,
+    // vs projected one after the other on the calling thread
+    {
+        const int frames = 8;
+        std::vector<std::vector<float2>> projected(frames, std::vector<float2>(input_size));
+        std::vector<transformation<float, float3, float, float2, SUPERSPEED>> frame_ptrs;
+        for (int f = 0; f < frames; f++)
+            frame_ptrs.emplace_back((float*)input.data(), &projected[f][0].x, input_size);
+        worker_pool pool(2);
+
+        std::cout << "Projection of " << frames << " frames, synchronous: ";
+        measure([&]()
+        {
+            for (auto&& p : frame_ptrs) p.apply(test_app<decltype(frame_ptrs)::value_type>());
+        });
+        std::cout << "Projection of " << frames << " frames, async on 2 threads: ";
+        measure([&]()
+        {
+            std::vector<std::future<async_result<void>>> done;
+            for (auto&& p : frame_ptrs)
+                done.push_back(apply_async(p, test_app<decltype(frame_ptrs)::value_type>(), pool));
+            for (auto&& d : done) d.wait();
+        });
+
+        // Only the newest frame matters: every submission cancels the one before it,
+        // the completion callbacks count what ran and what was dropped. The worker is held
+        // until all frames are queued, so none of them starts before it is superseded.
+        typedef decltype(frame_ptrs)::value_type frame_t;
+        std::fill(projected[frames - 1].begin(), projected[frames - 1].end(), float2{ -1.f, -1.f });
+        worker_pool single(1);
+        std::promise<void> gate;
+        std::shared_future<void> opened = gate.get_future().share();
+        single.post([opened]() { opened.wait(); });
+
+        std::atomic<int> completed(0), dropped(0), newest(-1);
+        cancellation previous;
+        for (int f = 0; f < frames; f++)
+        {
+            cancellation token;
+            apply_async_then(frame_ptrs[f], test_app<frame_t>(), [&, f](const async_result<void>& r)
+            {
+                if (r.status != ASYNC_DONE) { dropped++; return; }
+                completed++;
+                newest = f;
+            }, single, token);
+            previous.cancel();
+            previous = token;
+        }
+        gate.set_value();
+        std::promise<void> idle;
+        single.post([&idle]() { idle.set_value(); });
+        idle.get_future().wait();
+
+        size_t newest_mismatches = 0;
+        for (size_t i = 0; i < input_size; i++)
+            newest_mismatches += projected[frames - 1][i].x != projected[0][i].x || projected[frames - 1][i].y != projected[0][i].y;
+        std::cout << "Newest frame only: " << completed << " projected, " << dropped << " cancelled, frame "
+                  << newest << " ran, mismatches against frame 0: " << newest_mismatches << std::endl;
+
+        // What work throws reaches the caller, through the future or the callback status
+        auto failing = [](frame_t&) -> int { throw std::runtime_error("bad frame"); };
+        bool rethrown = false;
+        try { apply_async(frame_ptrs[0], failing, single).get(); }
+        catch (const std::runtime_error&) { rethrown = true; }
+        async_status callback_status = ASYNC_DONE;
+        std::promise<void> reported;
+        apply_async_then(frame_ptrs[0], failing, [&](const async_result<int>& r)
+        {
+            callback_status = r.status;
+            reported.set_value();
+        }, single);
+        reported.get_future().wait();
+
+        std::cout << "Async failures: future rethrows " << (rethrown ? "yes" : "no") << ", callback status "
+                  << (callback_status == ASYNC_FAILED ? "failed" : "other") << std::endl;
+    }
+
+    // Projection of a 201x150 bounding box and of 1003 tracked features only, against
+    // the whole 640x480 frame
+    {
+        const size_t width = 640, height = 480;
+        std::vector<float2> frame(input_size), box(input_size, float2{ -1.f, -1.f });
+        transformation<float, float3, float, float2, SUPERSPEED> frame_ptr((float*)input.data(), &frame[0].x, input_size);
+        std::cout << "Projection, whole frame, AVX: ";
+        measure([&]()
+        {
+            frame_ptr.apply(test_app<decltype(frame_ptr)>());
+        });
+
+        const roi box_rect{ 173, 91, 201, 150 };
+        roi_transformation<float, float3, float, float2, SUPERSPEED> box_ptr((float*)input.data(), &box[0].x, width, height, box_rect);
+        std::cout << "Projection, bounding box, AVX: ";
+        measure([&]()
+        {
+            box_ptr.apply(test_app<decltype(box_ptr)::row_type>());
+        });
+        size_t box_mismatches = 0, box_outside = 0;
+        for (size_t y = 0; y < height; y++)
+        {
+            for (size_t x = 0; x < width; x++)
+            {
+                const size_t i = y * width + x;
+                const bool inside = y >= box_rect.y && y < box_rect.y + box_rect.height &&
+                                    x >= box_ptr.first_column() && x < box_ptr.first_column() + box_ptr.columns();
+                if (inside) box_mismatches += box[i].x != frame[i].x || box[i].y != frame[i].y;
+                else box_outside += box[i].x != -1.f || box[i].y != -1.f;
+            }
+        }
+
+        std::vector<uint32_t> features(1003);
+        unsigned int seed = 17;
+        for (auto&& f : features)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            f = (seed >> 8) % (uint32_t)input_size;
+        }
+        std::vector<float2> tracked(features.size());
+        sparse_transformation<float, float3, float, float2, DEFAULT> sse_features((float*)input.data(), &tracked[0].x, features.data(), features.size());
+        sparse_transformation<float, float3, float, float2, SUPERSPEED> avx_features((float*)input.data(), &tracked[0].x, features.data(), features.size());
+        // Each engine against its own whole-frame projection, bit for bit (FMA or not)
+        std::vector<float2> sse_frame(input_size);
+        transformation<float, float3, float, float2, DEFAULT> sse_frame_ptr((float*)input.data(), &sse_frame[0].x, input_size);
+        sse_frame_ptr.apply(test_app<decltype(sse_frame_ptr)>());
+        auto feature_mismatches = [&](const std::vector<float2>& dense)
+        {
+            auto same = [](float a, float b) { return a == b || (a != a && b != b); };
+            size_t result = 0;
+            for (size_t i = 0; i < features.size(); i++)
+                result += !same(tracked[i].x, dense[features[i]].x) || !same(tracked[i].y, dense[features[i]].y);
+            return result;
+        };
+        std::cout << "Projection, tracked features, SSE: ";
+        measure([&]()
+        {
+            sse_features.apply(test_app<decltype(sse_features)>());
+        });
+        const auto sse_mismatches = feature_mismatches(sse_frame);
+        std::cout << "Projection, tracked features, AVX gather: ";
+        measure([&]()
+        {
+            avx_features.apply(test_app<decltype(avx_features)>());
+        });
+        std::cout << "Bounding box mismatches " << box_mismatches << ", written outside " << box_outside
+                  << "; feature mismatches SSE " << sse_mismatches << ", AVX " << feature_mismatches(frame) << std::endl;
+    }
+
+    // Deprojection of 640x480 depth with Brown-Conrady distortion: rays undistorted per
+    // pixel every frame vs taken from a table built once for the intrinsics
+    {
+        const pinhole camera{ 640, 480, 321.5f, 238.7f, 383.2f, 383.9f };
+        const brown_conrady lens{ { 0.08f, -0.21f, 0.0012f, -0.0007f, 0.09f } };
+        const size_t pixels = (size_t)camera.width * (size_t)camera.height;
+        std::vector<float> depth(pixels);
+        for (size_t i = 0; i < pixels; i++)
+            depth[i] = i % 97 == 0 ? 0.f : 0.8f + 0.5f * std::sin((i % 640) * 0.01f) * std::cos((i / 640) * 0.02f);
+        std::vector<float3> expected(pixels), points(pixels);
+
+        std::cout << "Deprojection with undistortion, scalar: ";
+        measure([&]()
+        {
+            for (size_t i = 0; i < pixels; i++)
+            {
+                const auto r = ray_cache<>::direction(camera, lens, (float)(i % 640), (float)(i / 640));
+                expected[i] = { r.x * depth[i], r.y * depth[i], depth[i] };
+            }
+        });
+
+        ray_cache<DEFAULT> sse_rays;
+        ray_cache<SUPERSPEED> avx_rays;
+        std::cout << "Ray table build, AVX: ";
+        measure([&]()
+        {
+            avx_rays.update(camera, brown_conrady());
+            avx_rays.update(camera, lens);
+        });
+        sse_rays.update(camera, lens);
+        const bool cached = !avx_rays.update(camera, lens);
+
+        auto deprojection_error = [&]()
+        {
+            float error = 0.f;
+            for (size_t i = 0; i < pixels; i++)
+                error = std::max(error, std::max(std::fabs(points[i].x - expected[i].x),
+                                 std::max(std::fabs(points[i].y - expected[i].y), std::fabs(points[i].z - expected[i].z))));
+            return error;
+        };
+        std::cout << "Deprojection from ray table, SSE: ";
+        measure([&]()
+        {
+            sse_rays.deproject(depth.data(), points.data());
+        });
+        const float sse_error = deprojection_error();
+        std::cout << "Deprojection from ray table, AVX: ";
+        measure([&]()
+        {
+            avx_rays.deproject(depth.data(), points.data());
+        });
+        std::cout << "Deprojection vs scalar: SSE " << sse_error << ", AVX " << deprojection_error()
+                  << ", table kept for the same intrinsics: " << (cached ? "yes" : "no") << std::endl;
+    }
+
+    // Voxel-grid downsampling of a 640x480 depth surface with noise and dropouts
+    {
+        const size_t width = 640, height = 480;
+        std::vector<float3> cloud(width * height);
+        unsigned int seed = 5;
+        for (size_t y = 0; y < height; y++)
+        {
+            for (size_t x = 0; x < width; x++)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                float z = 1.f + 0.3f * std::sin(x * 0.02f) + ((seed >> 8) % 1000) * 1e-5f;
+                if ((seed >> 24) < 20) z = 0.f;
+                cloud[y * width + x] = { ((float)x - 320.f) / 400.f * z, ((float)y - 240.f) / 400.f * z, z };
+            }
+        }
+        run_voxel_grid(cloud, 0.01f);
+        run_voxel_grid(cloud, 0.05f);
+    }
+
+    // Projection of frames placed by first touch: every worker pinned to a core of its node
+    // and processing the pages it touched, vs the same pages processed from the next node
+    {
+        const auto& topology = numa_topology::system();
+        std::cout << "NUMA nodes: " << topology.nodes() << ", CPUs:";
+        for (size_t n = 0; n < topology.nodes(); n++) std::cout << " " << topology.cpus(n).size();
+        std::cout << std::endl;
+
+        // Eight frames, well past the last level cache
+        const size_t frames = 8, points = input_size * frames;
+        std::vector<float> recording(points * 3);
+        for (size_t f = 0; f < frames; f++)
+            std::copy((float*)input.data(), (float*)input.data() + input_size * 3, recording.begin() + f * input_size * 3);
+
+        typedef transformation<float, float3, float, float2, SUPERSPEED> projection_t;
+        projection_t counter(nullptr, nullptr, points);
+        const auto plan = numa_partition(counter.blocks(), topology);
+
+        numa_buffer<float> placed_input(points * 3), placed_output(points * 2);
+        placed_input.first_touch(plan, counter.blocks(), recording.data());
+        placed_output.first_touch(plan, counter.blocks());
+        projection_t placed(placed_input.data(), placed_output.data(), points);
+
+        auto project = [](projection_t& slice)
+        {
+            slice.apply(test_app<projection_t>());
+            return slice.blocks();
+        };
+        std::cout << "Projection of 8 frames, node-local: ";
+        measure([&]()
+        {
+            numa_apply(placed, project, plan);
+        });
+
+        simd_ptr3.apply(test_app<decltype(simd_ptr3)>());
+        size_t mismatches = 0;
+        for (size_t i = 0; i < points; i++)
+            mismatches += placed_output.data()[i * 2] != output_ptr[i % input_size].x ||
+                          placed_output.data()[i * 2 + 1] != output_ptr[i % input_size].y;
+
+        if (topology.single_node())
+        {
+            std::cout << "Projection of 8 frames, remote: single node, nothing to compare" << std::endl;
+        }
+        else
+        {
+            const auto remote = remote_plan(plan, topology);
+            std::cout << "Projection of 8 frames, remote node: ";
+            measure([&]()
+            {
+                numa_apply(placed, project, remote);
+            });
+        }
+        std::cout << "NUMA projection mismatches: " << mismatches << std::endl;
+    }
+
+    // Points and infrared advanced together, no intermediate confidence buffer
+    std::vector<float> infrared(input_size), weighted(input_size * 3);
+    for (size_t i = 0; i < input_size; i++) infrared[i] = (float)(i % 256);
+    zip_transformation<float, float3, SUPERSPEED, stream<float, float3>, stream<float, float>> zip_ptr(
+        weighted.data(), input_size, (float*)input.data(), infrared.data());
+
+    std::cout << "Points + infrared: ";
+    measure([&]()
+    {
+        zip_ptr.apply(test_zip_app<decltype(zip_ptr)>());
+    });
+    // Infrared as the camera delivers it, 16-bit integer counts widened on load
+    std::vector<uint16_t> raw_infrared(input_size);
+    for (size_t i = 0; i < input_size; i++) raw_infrared[i] = (uint16_t)(i % 256);
+    std::vector<float> raw_weighted(input_size * 3);
+    zip_transformation<float, float3, SUPERSPEED, stream<float, float3>, encoded_stream<depth16, float>> raw_zip_ptr(
+        raw_weighted.data(), input_size, (float*)input.data(), raw_infrared.data());
+
+    std::cout << "Points + 16-bit infrared: ";
+    measure([&]()
+    {
+        raw_zip_ptr.apply(test_zip_app<decltype(raw_zip_ptr)>());
+    });
+    // Against the separate passes it replaces: a confidence buffer, then points scaled by it
+    {
+        std::vector<float> confidence(input_size);
+        for (size_t i = 0; i < input_size; i++) confidence[i] = infrared[i] * (1.f / 255.f);
+        const float* points = (const float*)input.data();
+        size_t zip_mismatches = 0, raw_mismatches = 0;
+        for (size_t i = 0; i < input_size * 3; i++)
+        {
+            zip_mismatches += weighted[i] != points[i] * confidence[i / 3];
+            raw_mismatches += raw_weighted[i] != points[i] * confidence[i / 3];
+        }
+        std::cout << "Zip vs separate passes mismatches: float infrared " << zip_mismatches
+                  << ", 16-bit infrared " << raw_mismatches << std::endl;
+    }
+
+    std::vector<simd::cloud_statistics> partial;
+    std::cout << "Projection + statistics, 4 threads: ";
+    measure([&]()
+    {
+        partial = parallel_apply(simd_ptr3, test_stats_app<decltype(simd_ptr3)>(), 4);
+    });
+    cloud_statistics stats;
+    for (auto&& p : partial) stats.merge(p);
+    std::cout << "Bounds: [" << stats.min[0] << ", " << stats.min[1] << ", " << stats.min[2] << "] - ["
+              << stats.max[0] << ", " << stats.max[1] << ", " << stats.max[2] << "]  centroid: ("
+              << stats.centroid(0) << ", " << stats.centroid(1) << ", " << stats.centroid(2) << ")  valid: "
+              << stats.count << std::endl;
+
+    // Against a scalar loop over the same points, and over 512 frames, past 2^24 valid
+    // points per float lane
+    {
+        cloud_statistics expected;
+        const size_t covered = simd_ptr3.size();
+        for (size_t i = 0; i < covered; i++)
+        {
+            const float p[3] = { input_ptr[i].x, input_ptr[i].y, input_ptr[i].z };
+            if (!(p[2] > 0.f)) continue;
+            for (int a = 0; a < 3; a++)
+            {
+                expected.min[a] = std::min(expected.min[a], p[a]);
+                expected.max[a] = std::max(expected.max[a], p[a]);
+                expected.sum[a] += p[a];
+            }
+            expected.count++;
+        }
+        size_t bound_mismatches = 0;
+        float centroid_error = 0.f;
+        for (int a = 0; a < 3; a++)
+        {
+            bound_mismatches += (stats.min[a] != expected.min[a]) + (stats.max[a] != expected.max[a]);
+            centroid_error = std::max(centroid_error, std::fabs(stats.centroid(a) - expected.centroid(a)));
+        }
+        test_stats_app<decltype(simd_ptr3)> many_frames;
+        many_frames.frames = 512;
+        cloud_statistics long_run;
+        simd_ptr3.apply([&](decltype(simd_ptr3)& ptr) { long_run = many_frames(ptr); });
+        std::cout << "Statistics vs scalar: bound mismatches " << bound_mismatches << ", valid " << stats.count
+                  << " of " << expected.count << ", max centroid error " << centroid_error << "; 512 frames valid "
+                  << long_run.count << " of " << expected.count * 512 << ", centroid z " << long_run.centroid(2)
+                  << " vs " << expected.centroid(2) << std::endl;
+    }
+
+    // (u, v) at 16 bits per component, and points stored as fp16
+    simd_ptr3.apply(test_app<decltype(simd_ptr3)>());
+    std::vector<float> reference((float*)output.data(), (float*)output.data() + input_size * 2);
+    std::vector<uint16_t> encoded(input_size * 2);
+    measure_encoded<decltype(simd_ptr3), fp16>(simd_ptr3, reference.data(), encoded);
+    measure_encoded<decltype(simd_ptr3), bf16>(simd_ptr3, reference.data(), encoded);
+    measure_encoded<decltype(simd_ptr3), unorm16>(simd_ptr3, reference.data(), encoded);
+
+    std::vector<uint16_t> half_points(input_size * 3);
+    for (size_t i = 0; i < half_points.size(); i++) half_points[i] = fp16::encode(((float*)input.data())[i]);
+    test_decoded_app<decltype(simd_ptr3), fp16> decoded_app;
+    decoded_app.source = half_points.data();
+    std::cout << "Input as fp16: ";
+    measure([&]()
+    {
+        simd_ptr3.apply(decoded_app);
+    });
+    float input_error = 0.f;
+    for (size_t i = 0; i < reference.size(); i++)
+        if (reference[i] >= 0.f && reference[i] <= 1.f) input_error = std::max(input_error, std::fabs(reference[i] - ((float*)output.data())[i]));
+    std::cout << "Max error of fp16 input (u, v) in frame: " << input_error << std::endl;
+
+    std::vector<frame_histograms<decltype(simd_ptr3)::engine_t>> histograms;
+    std::cout << "Depth / row / column histograms, 4 threads: ";
+    measure([&]()
+    {
+        histograms = parallel_apply(simd_ptr3, test_histogram_app<decltype(simd_ptr3)>(), 4);
+    });
+    for (size_t i = 1; i < histograms.size(); i++) histograms[0].merge(histograms[i]);
+    auto depth = histograms[0].z.counts();
+    std::cout << "Depth histogram (first bins): ";
+    for (int i = 0; i < 16; i++) std::cout << depth[i] << " ";
+    std::cout << std::endl;
+
+    // Against a scalar loop binning the same (u, v) and depth, with the same fused
+    // multiply-add for the bin index
+    {
+        simd_ptr3.apply(test_camera_app<decltype(simd_ptr3)>{ 0 });
+        auto bin = [](float value, const simd::histogram<decltype(simd_ptr3)::engine_t>& h)
+        {
+            const float scale = float(h.bins()) / (h.max() - h.min());
+            const float offset = -h.min() * float(h.bins()) / (h.max() - h.min());
+            return (size_t)std::min(std::max(std::fma(value, scale, offset), 0.f), float(h.bins() - 1));
+        };
+        std::vector<size_t> z(histograms[0].z.bins()), rows(histograms[0].rows.bins()), columns(histograms[0].columns.bins());
+        for (size_t i = 0; i < simd_ptr3.size(); i++)
+        {
+            if (!(input_ptr[i].z > 0.f)) continue;
+            z[bin(input_ptr[i].z, histograms[0].z)]++;
+            rows[bin(output_ptr[i].y, histograms[0].rows)]++;
+            columns[bin(output_ptr[i].x, histograms[0].columns)]++;
+        }
+        size_t bin_mismatches = 0;
+        for (size_t b = 0; b < z.size(); b++) bin_mismatches += z[b] != depth[b];
+        const auto simd_rows = histograms[0].rows.counts(), simd_columns = histograms[0].columns.counts();
+        for (size_t b = 0; b < rows.size(); b++) bin_mismatches += rows[b] != simd_rows[b];
+        for (size_t b = 0; b < columns.size(); b++) bin_mismatches += columns[b] != simd_columns[b];
+        std::cout << "Histogram bins vs scalar mismatches: " << bin_mismatches << " of "
+                  << z.size() + rows.size() + columns.size() << std::endl;
+    }
+
+    std::vector<char> outputs[3] = { output, output, output };
+    float* output_ptrs[3] = { (float*)outputs[0].data(), (float*)outputs[1].data(), (float*)outputs[2].data() };
+    multi_transformation<float, float3, float, float2, 3, SUPERSPEED> multi_ptr((float*)input.data(), output_ptrs, input_size);
+
+    std::cout << "3 cameras, one pass: ";
+    measure([&]()
+    {
+        multi_ptr.apply(test_multi_app<decltype(multi_ptr)>());
+    });
+    std::cout << "3 cameras, three passes: ";
+    measure([&]()
+    {
+        for (int c = 0; c < 3; c++) simd_ptr3.apply(test_camera_app<decltype(simd_ptr3)>{ c });
+    });
+    size_t camera_mismatches[3] = {};
+    for (int c = 0; c < 3; c++)
+    {
+        simd_ptr3.apply(test_camera_app<decltype(simd_ptr3)>{ c });
+        const float* single = (const float*)output.data();
+        for (size_t i = 0; i < input_size * 2; i++)
+            camera_mismatches[c] += single[i] != output_ptrs[c][i] && (single[i] == single[i] || output_ptrs[c][i] == output_ptrs[c][i]);
+    }
+    std::cout << "3 cameras vs single-camera passes, mismatches: " << camera_mismatches[0] << ", "
+              << camera_mismatches[1] << ", " << camera_mismatches[2] << std::endl;
+
+    run_pipeline(input);
+
     int x;
     std::cin >> x;
 }
\ No newline at end of file
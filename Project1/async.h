@@ -0,0 +1,243 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "core.h"
+
+namespace simd
+{
+    // Threads that run queued jobs in submission order. One pool is meant to be shared by
+    // every stream of a process (see shared()), so that frames in flight never start more
+    // threads than there are cores. Jobs still queued when the pool goes away are dropped,
+    // each runs its dropped function instead, on the thread destroying the pool.
+    class worker_pool
+    {
+    public:
+        explicit worker_pool(unsigned int threads = std::thread::hardware_concurrency())
+            : _stopping(false)
+        {
+            if (!threads) threads = 1;
+            for (unsigned int i = 0; i < threads; i++)
+                _workers.emplace_back([this]() { run(); });
+        }
+        ~worker_pool()
+        {
+            std::deque<job_type> dropped;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stopping = true;
+                dropped.swap(_jobs);
+            }
+            _wake.notify_all();
+            for (auto&& w : _workers) w.join();
+            for (auto&& j : dropped)
+                if (j.second) j.second();
+        }
+
+        worker_pool(const worker_pool&) = delete;
+        worker_pool& operator=(const worker_pool&) = delete;
+
+        static worker_pool& shared()
+        {
+            static worker_pool pool;
+            return pool;
+        }
+
+        // Jobs must not throw, apply_async() catches what work throws
+        void post(std::function<void()> job, std::function<void()> dropped = std::function<void()>())
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _jobs.push_back(std::make_pair(std::move(job), std::move(dropped)));
+            }
+            _wake.notify_one();
+        }
+
+        size_t threads() const { return _workers.size(); }
+
+        // Jobs waiting for a thread
+        size_t pending() const
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _jobs.size();
+        }
+
+    private:
+        typedef std::pair<std::function<void()>, std::function<void()>> job_type; // Job, and what runs if it is dropped
+
+        void run()
+        {
+            for (;;)
+            {
+                std::function<void()> job;
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _wake.wait(lock, [this]() { return _stopping || !_jobs.empty(); });
+                    if (_stopping) return;
+                    job = std::move(_jobs.front().first);
+                    _jobs.pop_front();
+                }
+                job();
+            }
+        }
+
+        mutable std::mutex _mutex;
+        std::condition_variable _wake;
+        std::deque<job_type> _jobs;
+        bool _stopping;
+        std::vector<std::thread> _workers;
+    };
+
+    // Shared flag to give up on a submitted frame, i.e. once a newer one has arrived.
+    // Copies refer to the same flag. A job checks it when it gets a thread, work that
+    // has already started runs to the end.
+    class cancellation
+    {
+    public:
+        cancellation() : _flag(std::make_shared<std::atomic<bool>>(false)) {}
+
+        void cancel() { _flag->store(true, std::memory_order_release); }
+        bool cancelled() const { return _flag->load(std::memory_order_acquire); }
+
+    private:
+        std::shared_ptr<std::atomic<bool>> _flag;
+    };
+
+    enum async_status
+    {
+        ASYNC_DONE,        // work ran, value holds what it returned
+        ASYNC_CANCELLED,   // cancelled before it started, or the pool went away first
+        ASYNC_UNSUPPORTED, // the engine cannot run on this CPU
+        ASYNC_FAILED,      // work threw, error holds the exception
+    };
+
+    template<class R>
+    struct async_result
+    {
+        async_status status;
+        R value;
+        std::exception_ptr error;
+    };
+    template<>
+    struct async_result<void>
+    {
+        async_status status;
+        std::exception_ptr error;
+    };
+
+    namespace detail
+    {
+        template<class R>
+        struct async_call
+        {
+            template<class TR, class F>
+            static async_result<R> run(TR& t, F& work)
+            {
+                async_result<R> result;
+                result.status = ASYNC_DONE;
+                result.value = work(t);
+                return result;
+            }
+            static async_result<R> fail(async_status status)
+            {
+                async_result<R> result;
+                result.status = status;
+                result.value = R();
+                return result;
+            }
+        };
+        template<>
+        struct async_call<void>
+        {
+            template<class TR, class F>
+            static async_result<void> run(TR& t, F& work)
+            {
+                work(t);
+                return fail(ASYNC_DONE);
+            }
+            static async_result<void> fail(async_status status)
+            {
+                async_result<void> result;
+                result.status = status;
+                return result;
+            }
+        };
+
+        template<class TR, class F>
+        async_result<decltype(std::declval<F&>()(std::declval<TR&>()))> run_job(TR& t, F& work, const cancellation& token)
+        {
+            typedef async_call<decltype(work(t))> call;
+            if (token.cancelled()) return call::fail(ASYNC_CANCELLED);
+            if (!TR::supported())
+            {
+                std::cout << "Engine not supported!" << std::endl;
+                return call::fail(ASYNC_UNSUPPORTED);
+            }
+            return call::run(t, work);
+        }
+    }
+
+    // work(t) on a thread of the pool, the caller goes on with the next frame. t is
+    // copied, it only refers to its buffers, which have to stay alive until the job is
+    // done. callback gets the async_result on the worker thread, ASYNC_FAILED if work
+    // threw, or ASYNC_CANCELLED on the thread destroying the pool if the job never ran.
+    // callback itself must not throw.
+    template<class TR, class F, class C>
+    void apply_async_then(const TR& t, F work, C callback, worker_pool& pool = worker_pool::shared(),
+                          cancellation token = cancellation())
+    {
+        typedef detail::async_call<decltype(work(std::declval<TR&>()))> call;
+        TR frame(t);
+        pool.post([frame, work, callback, token]() mutable
+        {
+            auto result = call::fail(ASYNC_FAILED);
+            try
+            {
+                result = detail::run_job(frame, work, token);
+            }
+            catch (...)
+            {
+                result.error = std::current_exception();
+            }
+            callback(result);
+        },
+        [callback]() mutable { callback(call::fail(ASYNC_CANCELLED)); });
+    }
+
+    // Same, with the async_result handed back through a future. What work throws is
+    // rethrown by future::get(), a job the pool dropped reads as ASYNC_CANCELLED.
+    template<class TR, class F>
+    auto apply_async(const TR& t, F work, worker_pool& pool = worker_pool::shared(), cancellation token = cancellation())
+        -> std::future<async_result<decltype(work(std::declval<TR&>()))>>
+    {
+        typedef detail::async_call<decltype(work(std::declval<TR&>()))> call;
+        typedef async_result<decltype(work(std::declval<TR&>()))> result_type;
+        auto promise = std::make_shared<std::promise<result_type>>();
+        auto future = promise->get_future();
+        TR frame(t);
+        pool.post([frame, work, token, promise]() mutable
+        {
+            try
+            {
+                promise->set_value(detail::run_job(frame, work, token));
+            }
+            catch (...)
+            {
+                promise->set_exception(std::current_exception());
+            }
+        },
+        [promise]() { promise->set_value(call::fail(ASYNC_CANCELLED)); });
+        return future;
+    }
+}
@@ -4,28 +4,10 @@
 #include <immintrin.h>
 
 #include "core.h"
+#include "cpu_features.h"
+#include "formats.h"
 #include "avx_shuffle.h"
-
-#if defined (ANDROID) || (defined (__linux__) && !defined (__x86_64__))
-bool has_avx() { return false; }
-#else
-    #ifdef _WIN32
-    #define cpuid(info, x)    __cpuidex(info, x, 0)
-    #else
-    #include <cpuid.h>
-    void cpuid(int info[4], int info_type) {
-        __cpuid_count(info_type, 0, info[0], info[1], info[2], info[3]);
-    }
-    #endif
-
-    bool has_avx()
-    {
-        int info[4];
-        cpuid(info, 0);
-        cpuid(info, 0x80000000);
-        return (info[2] & ((int)1 << 28)) != 0;
-    }
-#endif
+#include "sse_shuffle.h"
 
 namespace simd
 {
@@ -40,6 +22,8 @@ namespace simd
             return has_avx();
         }
 
+        enum { registers = SIMD_VECTOR_REGISTERS };
+
         template<typename T, typename Dummy = int>
         struct native_simd {};
 
@@ -53,7 +37,7 @@ namespace simd
 
             FORCEINLINE static void load(representation_type& target, const underlying_type* other)
             {
-                target._data = _mm256_castsi256_ps(_mm256_load_si256((const __m256i*)other));
+                target._data = _mm256_loadu_ps((const float*)other);
             }
 
             FORCEINLINE static void store(const representation_type& src, underlying_type* target)
@@ -67,7 +51,7 @@ namespace simd
             }
 
             FORCEINLINE native_simd(underlying_type data) : _data(data) {}
-            FORCEINLINE native_simd(const underlying_type* data) : _data(_mm256_castsi256_ps(_mm256_load_si256((const __m256i*)data))) {}
+            FORCEINLINE native_simd(const underlying_type* data) : _data(_mm256_loadu_ps((const float*)data)) {}
             FORCEINLINE native_simd() : _data(_mm256_set_ps(0, 0, 0, 0, 0, 0, 0, 0)) {}
             FORCEINLINE native_simd(const native_simd& data) { _data = data._data; }
 
@@ -87,6 +71,49 @@ namespace simd
             {
                 return native_simd(_mm256_mul_ps(_data, y._data));
             }
+            FORCEINLINE static native_simd fmadd(const native_simd& a, const native_simd& b, const native_simd& c)
+            {
+                return native_simd(_mm256_fmadd_ps(a._data, b._data, c._data));
+            }
+
+            FORCEINLINE static native_simd min(const native_simd& a, const native_simd& b)
+            {
+                return native_simd(_mm256_min_ps(a._data, b._data));
+            }
+            FORCEINLINE static native_simd max(const native_simd& a, const native_simd& b)
+            {
+                return native_simd(_mm256_max_ps(a._data, b._data));
+            }
+            FORCEINLINE static native_simd sqrt(const native_simd& a)
+            {
+                return native_simd(_mm256_sqrt_ps(a._data));
+            }
+
+            // Masks have all bits of a lane set
+            FORCEINLINE static native_simd greater(const native_simd& a, const native_simd& b)
+            {
+                return native_simd(_mm256_cmp_ps(a._data, b._data, _CMP_GT_OQ));
+            }
+            FORCEINLINE static native_simd less(const native_simd& a, const native_simd& b)
+            {
+                return native_simd(_mm256_cmp_ps(a._data, b._data, _CMP_LT_OQ));
+            }
+            FORCEINLINE static native_simd select(const native_simd& mask, const native_simd& a, const native_simd& b)
+            {
+                return native_simd(_mm256_blendv_ps(b._data, a._data, mask._data));
+            }
+
+            // Masks to and from one bit per lane, lane 0 in bit 0
+            FORCEINLINE static int movemask(const native_simd& mask)
+            {
+                return _mm256_movemask_ps(mask._data);
+            }
+            FORCEINLINE static native_simd mask_from_bits(int bits)
+            {
+                const __m256i lane_bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+                const __m256i set = _mm256_and_si256(_mm256_set1_epi32(bits), lane_bits);
+                return native_simd(_mm256_castsi256_ps(_mm256_cmpeq_epi32(set, lane_bits)));
+            }
             FORCEINLINE void store(underlying_type* ptr) const
             {
                 _mm256_storeu_ps((float*)ptr, _data);
@@ -97,6 +124,140 @@ namespace simd
             underlying_type _data;
         };
 
+        template<typename Dummy>
+        struct native_simd<double, Dummy>
+        {
+        public:
+            typedef __m256d underlying_type;
+            typedef native_simd<double> representation_type;
+            typedef native_simd<double> this_type;
+
+            FORCEINLINE static void load(representation_type& target, const underlying_type* other)
+            {
+                target._data = _mm256_loadu_pd((const double*)other);
+            }
+
+            FORCEINLINE static void store(const representation_type& src, underlying_type* target)
+            {
+                _mm256_storeu_pd((double*)target, src._data);
+            }
+
+            FORCEINLINE static underlying_type vectorize(double x)
+            {
+                return _mm256_set1_pd(x);
+            }
+
+            FORCEINLINE native_simd(underlying_type data) : _data(data) {}
+            FORCEINLINE native_simd(const underlying_type* data) : _data(_mm256_loadu_pd((const double*)data)) {}
+            FORCEINLINE native_simd() : _data(_mm256_setzero_pd()) {}
+            FORCEINLINE native_simd(const native_simd& data) { _data = data._data; }
+
+            FORCEINLINE native_simd operator+(const native_simd& y) const
+            {
+                return native_simd(_mm256_add_pd(_data, y._data));
+            }
+            FORCEINLINE native_simd operator-(const native_simd& y) const
+            {
+                return native_simd(_mm256_sub_pd(_data, y._data));
+            }
+            FORCEINLINE native_simd operator/(const native_simd& y) const
+            {
+                return native_simd(_mm256_div_pd(_data, y._data));
+            }
+            FORCEINLINE native_simd operator*(const native_simd& y) const
+            {
+                return native_simd(_mm256_mul_pd(_data, y._data));
+            }
+            FORCEINLINE static native_simd fmadd(const native_simd& a, const native_simd& b, const native_simd& c)
+            {
+                return native_simd(_mm256_fmadd_pd(a._data, b._data, c._data));
+            }
+
+            FORCEINLINE static native_simd min(const native_simd& a, const native_simd& b)
+            {
+                return native_simd(_mm256_min_pd(a._data, b._data));
+            }
+            FORCEINLINE static native_simd max(const native_simd& a, const native_simd& b)
+            {
+                return native_simd(_mm256_max_pd(a._data, b._data));
+            }
+            FORCEINLINE static native_simd sqrt(const native_simd& a)
+            {
+                return native_simd(_mm256_sqrt_pd(a._data));
+            }
+
+            FORCEINLINE static native_simd greater(const native_simd& a, const native_simd& b)
+            {
+                return native_simd(_mm256_cmp_pd(a._data, b._data, _CMP_GT_OQ));
+            }
+            FORCEINLINE static native_simd less(const native_simd& a, const native_simd& b)
+            {
+                return native_simd(_mm256_cmp_pd(a._data, b._data, _CMP_LT_OQ));
+            }
+            FORCEINLINE static native_simd select(const native_simd& mask, const native_simd& a, const native_simd& b)
+            {
+                return native_simd(_mm256_blendv_pd(b._data, a._data, mask._data));
+            }
+            FORCEINLINE void store(underlying_type* ptr) const
+            {
+                _mm256_storeu_pd((double*)ptr, _data);
+            }
+            FORCEINLINE operator underlying_type() const { return _data; }
+
+        private:
+            underlying_type _data;
+        };
+
+        template<typename Dummy>
+        struct native_simd<uint8_t, Dummy>
+        {
+        public:
+            typedef __m256i underlying_type;
+            typedef native_simd<uint8_t> representation_type;
+            typedef native_simd<uint8_t> this_type;
+
+            FORCEINLINE static void load(representation_type& target, const underlying_type* other)
+            {
+                target._data = _mm256_loadu_si256(other);
+            }
+
+            FORCEINLINE static void store(const representation_type& src, underlying_type* target)
+            {
+                _mm256_storeu_si256(target, src._data);
+            }
+
+            FORCEINLINE static underlying_type vectorize(uint8_t x)
+            {
+                return _mm256_set1_epi8((char)x);
+            }
+
+            FORCEINLINE native_simd(underlying_type data) : _data(data) {}
+            FORCEINLINE native_simd(const underlying_type* data) : _data(_mm256_loadu_si256(data)) {}
+            FORCEINLINE native_simd() : _data(_mm256_setzero_si256()) {}
+            FORCEINLINE native_simd(const native_simd& data) { _data = data._data; }
+
+            FORCEINLINE static native_simd min(const native_simd& a, const native_simd& b)
+            {
+                return native_simd(_mm256_min_epu8(a._data, b._data));
+            }
+            FORCEINLINE static native_simd max(const native_simd& a, const native_simd& b)
+            {
+                return native_simd(_mm256_max_epu8(a._data, b._data));
+            }
+            FORCEINLINE static native_simd select(const native_simd& mask, const native_simd& a, const native_simd& b)
+            {
+                return native_simd(_mm256_blendv_epi8(b._data, a._data, mask._data));
+            }
+            FORCEINLINE void store(underlying_type* ptr) const
+            {
+                _mm256_storeu_si256(ptr, _data);
+            }
+            FORCEINLINE operator underlying_type() const { return _data; }
+
+        private:
+            underlying_type _data;
+        };
+
         template<class T, unsigned int START, unsigned int GAP>
         struct gather_utils {};
 
@@ -198,5 +359,321 @@ namespace simd
                 scatter_loop<OT, ST, OT::blocks>::scatter(output_block, curr_var);
             }
         };
+
+        // vpshufb only shuffles within 128-bit halves. Counting the halves of a block of GAP
+        // registers, halves 0..GAP-1 hold elements 0-15 and halves GAP..2*GAP-1 elements
+        // 16-31, so pairing half o with half GAP + o lets the SSE byte tables gather both
+        // sets of lanes at once, and scatter splits the pairs back up the same way.
+        template<unsigned int START, unsigned int GAP>
+        struct gather_utils<uint8_t, START, GAP>
+        {
+            // Half O of the block in the low lane, half GAP + O in the high lane
+            template<class QT, unsigned int O>
+            FORCEINLINE static __m256i pair(const QT& res)
+            {
+                return _mm256_permute2x128_si256(res.fetch(O / 2), res.fetch((GAP + O) / 2), (O % 2) | ((2 + (GAP + O) % 2) << 4));
+            }
+
+            template<class GT, class QT, unsigned int J>
+            struct gather_loop
+            {
+                static void gather(const QT& res, GT& result)
+                {
+                    typedef sse::gather_shuffle_epi8<GAP, START, J - 1> table;
+                    if (table::used)
+                    {
+                        const __m256i part = _mm256_shuffle_epi8(pair<QT, J - 1>(res), _mm256_broadcastsi128_si256(table::shuffle()));
+                        result.assign(0, _mm256_or_si256(part, result.fetch(0)));
+                    }
+                    gather_loop<GT, QT, J - 1>::gather(res, result);
+                }
+            };
+            template<class GT, class QT>
+            struct gather_loop<GT, QT, 0>
+            {
+                static void gather(const QT& res, GT& result) {}
+            };
+
+            template<class GT, class QT>
+            static void gather(const QT& res, GT& result)
+            {
+                static_assert(QT::blocks == GAP, "Byte gather takes one block of GAP registers!");
+                gather_loop<GT, QT, GAP>::gather(res, result);
+            }
+        };
+
+        template<unsigned int START, unsigned int GAP>
+        struct scatter_utils<uint8_t, START, GAP>
+        {
+            // Bytes of half O (low lane) and half GAP + O (high lane) of the block
+            template<class ST, unsigned int O>
+            FORCEINLINE static __m256i spread(const ST& curr_var)
+            {
+                return _mm256_shuffle_epi8(curr_var.fetch(0), _mm256_broadcastsi128_si256(sse::scatter_shuffle_epi8<GAP, START, O>::shuffle()));
+            }
+            template<unsigned int K>
+            struct half
+            {
+                enum { pair = K < GAP ? K : K - GAP, lane = K < GAP ? 0 : 1 };
+            };
+
+            template<class OT, class ST, unsigned int J>
+            struct scatter_loop
+            {
+                static void scatter(OT& output_block, const ST& curr_var)
+                {
+                    typedef half<2 * (J - 1)> low;
+                    typedef half<2 * (J - 1) + 1> high;
+                    const __m256i first = spread<ST, low::pair>(curr_var);
+                    const __m256i second = spread<ST, high::pair>(curr_var);
+                    const __m256i part = _mm256_permute2x128_si256(first, second, low::lane | ((2 + high::lane) << 4));
+                    output_block.assign(J - 1, _mm256_or_si256(part, output_block.fetch(J - 1)));
+                    scatter_loop<OT, ST, J - 1>::scatter(output_block, curr_var);
+                }
+            };
+            template<class OT, class ST>
+            struct scatter_loop<OT, ST, 0>
+            {
+                static void scatter(OT& output_block, const ST& curr_var) {}
+            };
+
+            template<class OT, class ST>
+            static void scatter(OT& output_block, const ST& curr_var)
+            {
+                static_assert(OT::blocks == GAP, "Byte scatter fills one block of GAP registers!");
+                scatter_loop<OT, ST, GAP>::scatter(output_block, curr_var);
+            }
+        };
+
+        // Four double lanes per register, permuted across the 128-bit halves in one go
+        template<unsigned int START, unsigned int GAP>
+        struct gather_utils<double, START, GAP>
+        {
+            template<class GT, class QT, unsigned int J>
+            struct gather_loop
+            {
+                static void gather(const QT& res, GT& result)
+                {
+                    typedef avx::gather_shuffle_pd<GAP, START, J - 1> table;
+                    auto res1 = _mm256_permute4x64_pd(res.fetch(J - 1), table::shuffle);
+                    res1 = _mm256_and_pd(res1, _mm256_castsi256_pd(table::mask()));
+                    result.assign(0, _mm256_or_pd(res1, result.fetch(0)));
+                    gather_loop<GT, QT, J - 1>::gather(res, result);
+                }
+            };
+            template<class GT, class QT>
+            struct gather_loop<GT, QT, 0>
+            {
+                static void gather(const QT& res, GT& result) {}
+            };
+
+            template<class GT, class QT>
+            static void gather(const QT& res, GT& result)
+            {
+                gather_loop<GT, QT, QT::blocks>::gather(res, result);
+            }
+        };
+
+        template<unsigned int START, unsigned int GAP>
+        struct scatter_utils<double, START, GAP>
+        {
+            template<class OT, class ST, unsigned int J>
+            struct scatter_loop
+            {
+                static void scatter(OT& output_block, const ST& curr_var)
+                {
+                    typedef avx::scatter_shuffle_pd<GAP, START, J - 1> table;
+                    auto res1 = _mm256_permute4x64_pd(curr_var.fetch(0), table::shuffle);
+                    res1 = _mm256_and_pd(res1, _mm256_castsi256_pd(table::mask()));
+                    output_block.assign(J - 1, _mm256_or_pd(res1, output_block.fetch(J - 1)));
+                    scatter_loop<OT, ST, J - 1>::scatter(output_block, curr_var);
+                }
+            };
+            template<class OT, class ST>
+            struct scatter_loop<OT, ST, 0>
+            {
+                static void scatter(OT& output_block, const ST& curr_var) {}
+            };
+
+            template<class OT, class ST>
+            static void scatter(OT& output_block, const ST& curr_var)
+            {
+                scatter_loop<OT, ST, OT::blocks>::scatter(output_block, curr_var);
+            }
+        };
+
+        template<class T, unsigned int COMPONENTS>
+        struct strided_utils {};
+
+        template<unsigned int COMPONENTS>
+        struct strided_utils<float, COMPONENTS>
+        {
+            // Eight records, four floats each from the field on, paired into 256-bit
+            // registers (r, r + 4) and transposed within each 128-bit half
+            template<class VT>
+            FORCEINLINE static void transpose(const float* base, size_t stride, VT& result)
+            {
+                auto t0 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(base)), _mm_loadu_ps(base + 4 * stride), 1);
+                auto t1 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(base + stride)), _mm_loadu_ps(base + 5 * stride), 1);
+                auto t2 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(base + 2 * stride)), _mm_loadu_ps(base + 6 * stride), 1);
+                auto t3 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(base + 3 * stride)), _mm_loadu_ps(base + 7 * stride), 1);
+
+                auto a0 = _mm256_unpacklo_ps(t0, t1);
+                auto a1 = _mm256_unpackhi_ps(t0, t1);
+                auto a2 = _mm256_unpacklo_ps(t2, t3);
+                auto a3 = _mm256_unpackhi_ps(t2, t3);
+
+                const __m256 rows[4] = {
+                    _mm256_shuffle_ps(a0, a2, _MM_SHUFFLE(1, 0, 1, 0)),
+                    _mm256_shuffle_ps(a0, a2, _MM_SHUFFLE(3, 2, 3, 2)),
+                    _mm256_shuffle_ps(a1, a3, _MM_SHUFFLE(1, 0, 1, 0)),
+                    _mm256_shuffle_ps(a1, a3, _MM_SHUFFLE(3, 2, 3, 2)),
+                };
+                for (unsigned int i = 0; i < COMPONENTS && i < 4; i++)
+                    result.assign(i, rows[i]);
+            }
+
+            // Hardware gather, 32-bit indices of stride * lane
+            template<class VT>
+            FORCEINLINE static void hardware_gather(const float* base, size_t stride, VT& result)
+            {
+                const auto idx = _mm256_mullo_epi32(_mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0), _mm256_set1_epi32((int)stride));
+                for (unsigned int i = 0; i < COMPONENTS; i++)
+                    result.assign(i, _mm256_i32gather_ps(base + i, idx, sizeof(float)));
+            }
+
+            template<unsigned int STRIDE, bool FITS, class VT>
+            FORCEINLINE static void gather(const float* base, VT& result)
+            {
+                if (FITS) transpose(base, STRIDE, result);
+                else hardware_gather(base, STRIDE, result);
+            }
+
+            template<class VT>
+            FORCEINLINE static void gather(const float* base, size_t stride, bool fits, VT& result)
+            {
+                hardware_gather(base, stride, result);
+            }
+        };
+
+        template<class T, unsigned int COMPONENTS>
+        struct indexed_utils {};
+
+        // Records indices[0..7], records stride scalars apart, one vgatherdps per
+        // component. Indices times stride must fit 31 bits.
+        template<unsigned int COMPONENTS>
+        struct indexed_utils<float, COMPONENTS>
+        {
+            template<class VT>
+            FORCEINLINE static void gather(const float* base, const uint32_t* indices, size_t stride, VT& result)
+            {
+                const auto idx = _mm256_mullo_epi32(_mm256_loadu_si256((const __m256i*)indices), _mm256_set1_epi32((int)stride));
+                for (unsigned int i = 0; i < COMPONENTS; i++)
+                    result.assign(i, _mm256_i32gather_ps(base + i, idx, sizeof(float)));
+            }
+        };
+
+        // BT.601 limited range YUV to RGB in 6-bit fixed point, the arithmetic of
+        // engine<NAIVE>::yuv_utils on sixteen 16-bit lanes at a time. The unpacks and
+        // the pack both work within 128-bit halves, so lanes come back in order.
+        struct yuv_utils
+        {
+            FORCEINLINE static void to_rgb(__m256i y, __m256i u, __m256i v, __m256i& r, __m256i& g, __m256i& b)
+            {
+                const __m256i zero = _mm256_setzero_si256();
+                __m256i r0, g0, b0, r1, g1, b1;
+                to_rgb16(_mm256_unpacklo_epi8(y, y), _mm256_unpacklo_epi8(u, zero), _mm256_unpacklo_epi8(v, zero), r0, g0, b0);
+                to_rgb16(_mm256_unpackhi_epi8(y, y), _mm256_unpackhi_epi8(u, zero), _mm256_unpackhi_epi8(v, zero), r1, g1, b1);
+                r = _mm256_packus_epi16(r0, r1);
+                g = _mm256_packus_epi16(g0, g1);
+                b = _mm256_packus_epi16(b0, b1);
+            }
+
+        private:
+            FORCEINLINE static void to_rgb16(__m256i y257, __m256i u, __m256i v, __m256i& r, __m256i& g, __m256i& b)
+            {
+                const __m256i luma = _mm256_mulhi_epu16(y257, _mm256_set1_epi16(18997));
+                const __m256i bias = _mm256_set1_epi16(-1160);
+                const __m256i d = _mm256_sub_epi16(u, _mm256_set1_epi16(128));
+                const __m256i e = _mm256_sub_epi16(v, _mm256_set1_epi16(128));
+                const __m256i chroma_g = _mm256_add_epi16(_mm256_mullo_epi16(d, _mm256_set1_epi16(-25)), _mm256_mullo_epi16(e, _mm256_set1_epi16(-52)));
+                r = _mm256_srai_epi16(_mm256_adds_epi16(_mm256_adds_epi16(luma, _mm256_mullo_epi16(e, _mm256_set1_epi16(102))), bias), 6);
+                g = _mm256_srai_epi16(_mm256_adds_epi16(_mm256_adds_epi16(luma, chroma_g), bias), 6);
+                b = _mm256_srai_epi16(_mm256_adds_epi16(_mm256_adds_epi16(luma, _mm256_mullo_epi16(d, _mm256_set1_epi16(129))), bias), 6);
+            }
+        };
+
+        // Eight 32-bit lanes holding 16-bit values down to eight uint16
+        FORCEINLINE static void store_low16(__m256i x, uint16_t* target)
+        {
+            const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(x, x), _MM_SHUFFLE(3, 1, 2, 0));
+            _mm_storeu_si128((__m128i*)target, _mm256_castsi256_si128(packed));
+        }
+
+        // 16-bit storage formats
+        template<class F>
+        struct format_utils {};
+    };
+
+    template<>
+    struct engine<SUPERSPEED>::format_utils<fp16>
+    {
+        FORCEINLINE static void encode(__m256 value, uint16_t* target)
+        {
+            _mm_storeu_si128((__m128i*)target, _mm256_cvtps_ph(value, _MM_FROUND_TO_NEAREST_INT));
+        }
+        FORCEINLINE static __m256 decode(const uint16_t* source)
+        {
+            return _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)source));
+        }
+    };
+
+    template<>
+    struct engine<SUPERSPEED>::format_utils<bf16>
+    {
+        FORCEINLINE static void encode(__m256 value, uint16_t* target)
+        {
+            const __m256i bits = _mm256_castps_si256(value);
+            const __m256i nan = _mm256_castps_si256(_mm256_cmp_ps(value, value, _CMP_UNORD_Q));
+            const __m256i lsb = _mm256_and_si256(_mm256_srli_epi32(bits, 16), _mm256_set1_epi32(1));
+            const __m256i bias = _mm256_andnot_si256(nan, _mm256_add_epi32(_mm256_set1_epi32(0x7FFF), lsb));
+            const __m256i quiet = _mm256_and_si256(nan, _mm256_set1_epi32(0x400000));
+            engine<SUPERSPEED>::store_low16(_mm256_srli_epi32(_mm256_or_si256(_mm256_add_epi32(bits, bias), quiet), 16), target);
+        }
+        FORCEINLINE static __m256 decode(const uint16_t* source)
+        {
+            const __m256i x = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)source));
+            return _mm256_castsi256_ps(_mm256_slli_epi32(x, 16));
+        }
+    };
+
+    template<>
+    struct engine<SUPERSPEED>::format_utils<unorm16>
+    {
+        FORCEINLINE static void encode(__m256 value, uint16_t* target)
+        {
+            const __m256 clamped = _mm256_min_ps(_mm256_max_ps(value, _mm256_setzero_ps()), _mm256_set1_ps(1.f));
+            const __m256 scaled = _mm256_fmadd_ps(clamped, _mm256_set1_ps(65535.f), _mm256_set1_ps(0.5f));
+            engine<SUPERSPEED>::store_low16(_mm256_cvttps_epi32(scaled), target);
+        }
+        FORCEINLINE static __m256 decode(const uint16_t* source)
+        {
+            const __m256i x = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)source));
+            return _mm256_mul_ps(_mm256_cvtepi32_ps(x), _mm256_set1_ps(1.f / 65535.f));
+        }
+    };
+
+    template<>
+    struct engine<SUPERSPEED>::format_utils<depth16>
+    {
+        FORCEINLINE static void encode(__m256 value, uint16_t* target)
+        {
+            const __m256 clamped = _mm256_min_ps(_mm256_max_ps(value, _mm256_setzero_ps()), _mm256_set1_ps(65535.f));
+            engine<SUPERSPEED>::store_low16(_mm256_cvttps_epi32(_mm256_add_ps(clamped, _mm256_set1_ps(0.5f))), target);
+        }
+        FORCEINLINE static __m256 decode(const uint16_t* source)
+        {
+            return _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)source)));
+        }
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "core.h"
+#include "simd.h"
+
+namespace simd
+{
+    // Packed 8-bit pixel formats, the element types of byte transformations. YUV 4:2:2
+    // elements are macropixels of two pixels that share U and V, so they convert into
+    // pairs of RGB pixels.
+    struct yuyv8 { uint8_t y0, u, y1, v; };
+    struct uyvy8 { uint8_t u, y0, v, y1; };
+    struct rgb8 { uint8_t r, g, b; };
+    struct bgr8 { uint8_t b, g, r; };
+    struct rgba8 { uint8_t r, g, b, a; };
+    struct rgb8_pair { rgb8 first, second; };
+    struct rgba8_pair { rgba8 first, second; };
+
+    // Conversions as transformations, gather() deinterleaves the bytes of the input
+    // pixels and scatter() interleaves the output channels
+    template<engine_type ET = DEFAULT>
+    using yuyv_to_rgb = transformation<uint8_t, yuyv8, uint8_t, rgb8_pair, ET>;
+    template<engine_type ET = DEFAULT>
+    using yuyv_to_rgba = transformation<uint8_t, yuyv8, uint8_t, rgba8_pair, ET>;
+    template<engine_type ET = DEFAULT>
+    using uyvy_to_rgb = transformation<uint8_t, uyvy8, uint8_t, rgb8_pair, ET>;
+    template<engine_type ET = DEFAULT>
+    using uyvy_to_rgba = transformation<uint8_t, uyvy8, uint8_t, rgba8_pair, ET>;
+    template<engine_type ET = DEFAULT>
+    using bgr_to_rgb = transformation<uint8_t, bgr8, uint8_t, rgb8, ET>;
+    template<engine_type ET = DEFAULT>
+    using bgr_to_rgba = transformation<uint8_t, bgr8, uint8_t, rgba8, ET>;
+
+    // BT.601 limited range YUV to RGB in 6-bit fixed point, bit exact across engines,
+    // see engine<NAIVE>::yuv_utils for the arithmetic
+    template<typename E>
+    class yuv_kernel
+    {
+    public:
+        typedef broadcast<E, uint8_t> broadcast_t;
+
+        yuv_kernel() : _opaque(255) {}
+
+        // Both pixels of the macropixels, Y0 and Y1 share U and V
+        template<int K>
+        FORCEINLINE void apply(const vector<E, uint8_t, K>& y0, const vector<E, uint8_t, K>& y1,
+                               const vector<E, uint8_t, K>& u, const vector<E, uint8_t, K>& v,
+                               vector<E, uint8_t, K>& r0, vector<E, uint8_t, K>& g0, vector<E, uint8_t, K>& b0,
+                               vector<E, uint8_t, K>& r1, vector<E, uint8_t, K>& g1, vector<E, uint8_t, K>& b1) const
+        {
+            apply(y0, u, v, r0, g0, b0);
+            apply(y1, u, v, r1, g1, b1);
+        }
+
+        template<int K>
+        FORCEINLINE void apply(const vector<E, uint8_t, K>& y, const vector<E, uint8_t, K>& u, const vector<E, uint8_t, K>& v,
+                               vector<E, uint8_t, K>& r, vector<E, uint8_t, K>& g, vector<E, uint8_t, K>& b) const
+        {
+            for (int i = 0; i < K; i++)
+            {
+                typename vector<E, uint8_t, K>::underlying_t rr, gg, bb;
+                E::yuv_utils::to_rgb(y.fetch(i), u.fetch(i), v.fetch(i), rr, gg, bb);
+                r.assign(i, rr);
+                g.assign(i, gg);
+                b.assign(i, bb);
+            }
+        }
+
+        // Alpha channel for RGBA outputs
+        template<int K>
+        FORCEINLINE vector<E, uint8_t, K> opaque() const
+        {
+            vector<E, uint8_t, K> result;
+            for (int i = 0; i < K; i++)
+                result.assign(i, _opaque.value());
+            return result;
+        }
+
+    private:
+        broadcast_t _opaque;
+    };
+}
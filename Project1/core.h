@@ -1,4 +1,5 @@
 #pragma once
+#include <stddef.h>
 #include <vector>
 #include <assert.h>
 #include <type_traits>
@@ -11,6 +12,13 @@ typedef unsigned char byte;
 #define FORCEINLINE inline __attribute__((always_inline))
 #endif
 
+// Architectural vector registers, 16 XMM / YMM in 64-bit mode and 8 in 32-bit mode
+#if defined(_M_X64) || defined(__x86_64__)
+#define SIMD_VECTOR_REGISTERS 16
+#else
+#define SIMD_VECTOR_REGISTERS 8
+#endif
+
 namespace simd
 {
     enum engine_type
@@ -27,4 +35,34 @@ namespace simd
 
     template<engine_type ET>
     struct fallback_engine { static const engine_type FT = ET; };
+
+    // Non-owning view over a contiguous buffer, used to hand sub-ranges to workers
+    template<class T>
+    class span
+    {
+    public:
+        span() : _data(nullptr), _size(0) {}
+        span(T* data, size_t size) : _data(data), _size(size) {}
+        template<size_t N>
+        span(T (&data)[N]) : _data(data), _size(N) {}
+        span(std::vector<T>& data) : _data(data.data()), _size(data.size()) {}
+
+        T* data() const { return _data; }
+        size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+
+        T* begin() const { return _data; }
+        T* end() const { return _data + _size; }
+        T& operator[](size_t idx) const { return _data[idx]; }
+
+        span subspan(size_t offset, size_t count) const
+        {
+            assert(offset + count <= _size);
+            return span(_data + offset, count);
+        }
+
+    private:
+        T* _data;
+        size_t _size;
+    };
 }
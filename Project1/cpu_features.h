@@ -0,0 +1,53 @@
+#pragma once
+
+// CPU feature checks, free of any intrinsics, so that code built for the baseline
+// instruction set can decide which engine to run before touching one. static, every
+// translation unit keeps the copy built with its own flags.
+
+#if defined (ANDROID) || (defined (__linux__) && !defined (__x86_64__))
+static inline bool has_ssse3() { return true; }
+static inline bool has_avx() { return false; }
+#else
+    #ifdef _WIN32
+    #include <intrin.h>
+    #define cpuid(info, x)    __cpuidex(info, x, 0)
+    static inline unsigned long long xgetbv() { return _xgetbv(0); }
+    #else
+    #include <cpuid.h>
+    static inline void cpuid(int info[4], int info_type) {
+        __cpuid_count(info_type, 0, info[0], info[1], info[2], info[3]);
+    }
+    static inline unsigned long long xgetbv() {
+        unsigned int eax, edx;
+        __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return ((unsigned long long)edx << 32) | eax;
+    }
+    #endif
+
+    // SSE engine shuffles (pshufb) are SSSE3
+    static inline bool has_ssse3()
+    {
+        int info[4];
+        cpuid(info, 1);
+        return (info[2] & ((int)1 << 9)) != 0;
+    }
+
+    // The AVX engine relies on AVX2 lane permutes, FMA3 and F16C, so AVX alone is not
+    // enough, and the OS has to preserve the upper halves of the YMM registers
+    static inline bool has_avx()
+    {
+        int info[4];
+        cpuid(info, 0);
+        if (info[0] < 7) return false;
+
+        cpuid(info, 1);
+        const bool fma = (info[2] & ((int)1 << 12)) != 0;
+        const bool osxsave = (info[2] & ((int)1 << 27)) != 0;
+        const bool avx = (info[2] & ((int)1 << 28)) != 0;
+        const bool f16c = (info[2] & ((int)1 << 29)) != 0;
+        if (!fma || !osxsave || !avx || !f16c || (xgetbv() & 0x6) != 0x6) return false;
+
+        cpuid(info, 7);
+        return (info[1] & ((int)1 << 5)) != 0;
+    }
+#endif
@@ -0,0 +1,269 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <stdint.h>
+#include <vector>
+
+#include "core.h"
+#include "formats.h"
+#include "simd.h"
+
+namespace simd
+{
+    // N consecutive pixels of one image row, what a decimated pixel takes from every input row
+    template<typename T, int N>
+    struct decimation_block
+    {
+        T taps[N];
+    };
+
+    // Batcher's odd-even merge sort of COUNT registers, lane by lane, for any COUNT. The
+    // network is unrolled at compile time into min / max pairs on fixed array indices, each
+    // instance is one (p, k, j, i) step of the textbook loops and names the step after it:
+    //   for (p = 1; p < n; p += p)
+    //     for (k = p; k >= 1; k /= 2)
+    //       for (j = k % p; j + k < n; j += 2 * k)
+    //         for (i = 0; i < k && i + j + k < n; i++)
+    //           if ((i + j) / (2 * p) == (i + j + k) / (2 * p)) compare(i + j, i + j + k)
+    template<class V, int COUNT, int P = 1, int K = 1, int J = 0, int I = 0, bool DONE = (P >= COUNT)>
+    struct sorting_network
+    {
+        enum { active = J + K < COUNT && I < K && I + J + K < COUNT && (I + J) / (2 * P) == (I + J + K) / (2 * P) };
+        enum { low = active ? I + J : 0, high = active ? I + J + K : 0 };
+
+        enum { next_i = I + 1 < K && I + 1 + J + K < COUNT };
+        enum { next_j = !next_i && J + 3 * K < COUNT };
+        enum { next_k = !next_i && !next_j && K > 1 };
+        enum { next_p = !next_i && !next_j && !next_k };
+
+        FORCEINLINE static void sort(std::array<V, COUNT>& v)
+        {
+            if (active)
+            {
+                const V smaller = V::min(v[low], v[high]);
+                v[high] = V::max(v[low], v[high]);
+                v[low] = smaller;
+            }
+            sorting_network<V, COUNT,
+                next_p ? 2 * P : P,
+                next_p ? 2 * P : next_k ? K / 2 : K,
+                next_i ? J : next_j ? J + 2 * K : next_k ? (K / 2) % P : 0,
+                next_i ? I + 1 : 0>::sort(v);
+        }
+    };
+    template<class V, int COUNT, int P, int K, int J, int I>
+    struct sorting_network<V, COUNT, P, K, J, I, true>
+    {
+        FORCEINLINE static void sort(std::array<V, COUNT>& v) {}
+    };
+
+    enum decimation_mode
+    {
+        DECIMATE_MEDIAN, // Median of the pixels with depth, the upper one of an even count
+        DECIMATE_MEAN,   // Mean of the pixels with depth
+    };
+
+    // Reduces a depth image by N (2, 3 or 4) in both directions. Every output pixel comes
+    // from an N x N block of input pixels, pixels without depth (0) are left out and a
+    // block without any depth gives 0. Each input row of a block is one transformation
+    // over decimation_block<N> elements, so the gather deinterleaves the N taps of a lane
+    // into N registers, and N rows make the N x N taps. The median sorts the taps with
+    // sorting_network in registers, missing depth sorted last as +inf. Input columns and
+    // rows past the last whole block are dropped, output pixels past the last whole
+    // register are done one at a time.
+    template<int N, engine_type ET = DEFAULT>
+    class decimation_filter
+    {
+    public:
+        typedef transformation<float, decimation_block<float, N>, float, float, ET> row_type;
+        typedef typename row_type::engine_t engine_t;
+        typedef typename row_type::gather_type vector_t;
+        typedef typename vector_t::underlying_t underlying_t;
+        typedef broadcast<engine_t, float> broadcast_t;
+        typedef transformation<float, float, float, float, ET> line_type;
+
+        enum { taps = N * N };
+        enum { lanes = row_type::blocks_gather };
+
+        static_assert(N >= 2 && N <= 4, "Decimation is 2x, 3x or 4x!");
+        static_assert(row_type::elements_in == N, "Block must gather into N registers!");
+
+        decimation_filter(size_t width, size_t height, decimation_mode mode = DECIMATE_MEDIAN)
+            : _width(width), _height(height), _mode(mode)
+        {
+            assert(width >= N && height >= N);
+        }
+
+        size_t width() const { return _width; }
+        size_t height() const { return _height; }
+        size_t output_width() const { return _width / N; }
+        size_t output_height() const { return _height / N; }
+
+        static bool supported()
+        {
+            static const bool result = engine_t::can_run();
+            return result;
+        }
+
+        // output holds output_width() x output_height() pixels
+        void apply(const float* depth, float* output)
+        {
+            if (!supported())
+            {
+                std::cout << "Engine not supported!" << std::endl;
+                return;
+            }
+
+            const float* rows[N];
+            for (size_t r = 0; r < output_height(); r++)
+            {
+                for (int k = 0; k < N; k++)
+                    rows[k] = depth + (r * N + k) * _width;
+                decimate_row(rows, output + r * output_width());
+            }
+        }
+
+        // Integer depth units, decoded into float lines N rows at a time and encoded back
+        void apply(const uint16_t* depth, uint16_t* output)
+        {
+            if (!supported())
+            {
+                std::cout << "Engine not supported!" << std::endl;
+                return;
+            }
+
+            _lines.resize((N + 1) * _width);
+            float* reduced = _lines.data() + N * _width;
+            const float* rows[N];
+            for (size_t r = 0; r < output_height(); r++)
+            {
+                for (int k = 0; k < N; k++)
+                {
+                    float* line = _lines.data() + k * _width;
+                    decode_line(depth + (r * N + k) * _width, line, _width);
+                    rows[k] = line;
+                }
+                decimate_row(rows, reduced);
+                encode_line(reduced, output + r * output_width(), output_width());
+            }
+        }
+
+        // One output pixel from its N x N taps, what the lanes compute and the tail runs
+        static float decimate(const float* block, decimation_mode mode)
+        {
+            float valid[taps];
+            int count = 0;
+            float sum = 0.f;
+            for (int t = 0; t < taps; t++)
+            {
+                if (!(block[t] > 0.f)) continue;
+                valid[count++] = block[t];
+                sum += block[t];
+            }
+            if (count == 0) return 0.f;
+            if (mode == DECIMATE_MEAN) return sum / count;
+            std::sort(valid, valid + count);
+            return valid[count / 2];
+        }
+
+    private:
+        void decimate_row(const float* const* rows, float* output)
+        {
+            const size_t blocks = output_width() / lanes;
+            if (blocks)
+            {
+                std::array<row_type, N> streams;
+                for (int k = 0; k < N; k++)
+                    streams[k].bind(reinterpret_cast<float*>(const_cast<float*>(rows[k])), output, blocks * lanes);
+
+                const broadcast_t zero(0.f), half(0.5f);
+                vector_t none, one, inf;
+                one.assign(0, broadcast_t(1.f).value());
+                inf.assign(0, broadcast_t(std::numeric_limits<float>::infinity()).value());
+
+                for (size_t b = 0; b < blocks; b++)
+                {
+                    std::array<vector_t, taps> block;
+                    for (int k = 0; k < N; k++)
+                    {
+                        typename row_type::iterator i(&streams[k], b);
+                        const auto row = i.gather(i.load());
+                        for (int c = 0; c < N; c++)
+                            block[k * N + c] = row[c];
+                    }
+
+                    // Taps with depth counted and summed in every lane, the rest (0, negative
+                    // or NaN) masked out before they reach the sum
+                    vector_t count, sum;
+                    for (int t = 0; t < taps; t++)
+                    {
+                        const auto valid = block[t].greater(zero);
+                        count = count + vector_t::select(valid, one, none);
+                        if (_mode == DECIMATE_MEDIAN)
+                            block[t] = vector_t::select(valid, block[t], inf);
+                        else
+                            sum = sum + vector_t::select(valid, block[t], none);
+                    }
+
+                    vector_t result;
+                    if (_mode == DECIMATE_MEAN)
+                    {
+                        result = sum / vector_t::max(count, one);
+                    }
+                    else
+                    {
+                        sorting_network<vector_t, taps>::sort(block);
+                        // Element count / 2 of the sorted taps, picked by comparing the count
+                        result = block[0];
+                        for (int t = 1; t <= taps / 2; t++)
+                            result = vector_t::select(count.greater(broadcast_t(2.f * t - 0.5f)), block[t], result);
+                        result = vector_t::select(count.greater(half), result, none);
+                    }
+                    result.store(reinterpret_cast<underlying_t*>(output + b * lanes));
+                }
+            }
+
+            float block[taps];
+            for (size_t x = blocks * lanes; x < output_width(); x++)
+            {
+                for (int k = 0; k < N; k++)
+                    for (int c = 0; c < N; c++)
+                        block[k * N + c] = rows[k][x * N + c];
+                output[x] = decimate(block, _mode);
+            }
+        }
+
+        void decode_line(const uint16_t* source, float* target, size_t count)
+        {
+            const size_t whole = count / lanes * lanes;
+            if (whole)
+            {
+                line_type line(target, target, whole);
+                for (auto i : line)
+                    i.store(i.load(source, depth16()));
+            }
+            for (size_t x = whole; x < count; x++)
+                target[x] = depth16::decode(source[x]);
+        }
+
+        void encode_line(float* source, uint16_t* target, size_t count)
+        {
+            const size_t whole = count / lanes * lanes;
+            if (whole)
+            {
+                line_type line(source, source, whole);
+                for (auto i : line)
+                    i.store(i.load(), target, depth16());
+            }
+            for (size_t x = whole; x < count; x++)
+                target[x] = depth16::encode(source[x]);
+        }
+
+        size_t _width;
+        size_t _height;
+        decimation_mode _mode;
+        std::vector<float> _lines; // N decoded input rows and the reduced row, uint16 frames only
+    };
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+namespace simd
+{
+    // 16-bit storage formats for float data, passed as tags to the iterator's
+    // load / store overloads. Scalar conversions are the reference every engine
+    // has to match, and are what the naive engine runs.
+
+    // IEEE 754 binary16, round to nearest even
+    struct fp16
+    {
+        static const char* name() { return "fp16"; }
+
+        static uint16_t encode(float value)
+        {
+            uint32_t x;
+            memcpy(&x, &value, sizeof(x));
+            const uint32_t sign = x & 0x80000000u;
+            x ^= sign;
+
+            uint32_t result;
+            if (x >= (127u + 16) << 23) // Inf, NaN (quieted, payload kept as F16C does) or too large
+            {
+                result = x > 0x7F800000u ? 0x7E00 | ((x >> 13) & 0x3FF) : 0x7C00;
+            }
+            else if (x < 113u << 23) // Subnormal or zero, let float addition do the rounding
+            {
+                const uint32_t magic_bits = ((127u - 15) + (23 - 10) + 1) << 23;
+                float magic, f;
+                memcpy(&magic, &magic_bits, sizeof(magic));
+                memcpy(&f, &x, sizeof(f));
+                f += magic;
+                memcpy(&x, &f, sizeof(x));
+                result = x - magic_bits;
+            }
+            else
+            {
+                const uint32_t odd = (x >> 13) & 1;
+                x += ((uint32_t)(15 - 127) << 23) + 0xFFF + odd;
+                result = x >> 13;
+            }
+            return (uint16_t)(result | (sign >> 16));
+        }
+
+        static float decode(uint16_t value)
+        {
+            const uint32_t shifted_exp = 0x7C00u << 13;
+            uint32_t x = ((uint32_t)value & 0x7FFF) << 13;
+            const uint32_t exp = x & shifted_exp;
+            x += (127u - 15) << 23;
+
+            float result;
+            if (exp == shifted_exp) // Inf / NaN
+            {
+                x += (128u - 16) << 23;
+                memcpy(&result, &x, sizeof(result));
+            }
+            else if (exp == 0) // Subnormal / zero
+            {
+                const uint32_t magic_bits = 113u << 23;
+                float magic;
+                memcpy(&magic, &magic_bits, sizeof(magic));
+                x += 1u << 23;
+                memcpy(&result, &x, sizeof(result));
+                result -= magic;
+            }
+            else
+            {
+                memcpy(&result, &x, sizeof(result));
+            }
+            return (value & 0x8000) ? -result : result;
+        }
+    };
+
+    // Upper half of a float, round to nearest even, NaN stays NaN
+    struct bf16
+    {
+        static const char* name() { return "bf16"; }
+
+        static uint16_t encode(float value)
+        {
+            uint32_t x;
+            memcpy(&x, &value, sizeof(x));
+            if ((x & 0x7FFFFFFFu) > 0x7F800000u) return (uint16_t)((x >> 16) | 0x40);
+            x += 0x7FFF + ((x >> 16) & 1);
+            return (uint16_t)(x >> 16);
+        }
+
+        static float decode(uint16_t value)
+        {
+            const uint32_t x = (uint32_t)value << 16;
+            float result;
+            memcpy(&result, &x, sizeof(result));
+            return result;
+        }
+    };
+
+    // Fixed point over [0, 1], i.e. normalized (u, v), clamped, NaN becomes 0
+    struct unorm16
+    {
+        static const char* name() { return "unorm16"; }
+
+        static uint16_t encode(float value)
+        {
+            if (!(value > 0.f)) return 0;
+            if (value > 1.f) value = 1.f;
+            return (uint16_t)(value * 65535.f + 0.5f);
+        }
+
+        static float decode(uint16_t value)
+        {
+            return value * (1.f / 65535.f);
+        }
+    };
+
+    // Integer depth units as the camera delivers them, rounded and clamped, NaN becomes 0
+    struct depth16
+    {
+        static const char* name() { return "depth16"; }
+
+        static uint16_t encode(float value)
+        {
+            if (!(value > 0.f)) return 0;
+            if (value > 65535.f) value = 65535.f;
+            return (uint16_t)(value + 0.5f);
+        }
+
+        static float decode(uint16_t value)
+        {
+            return (float)value;
+        }
+    };
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <vector>
+
+#include "core.h"
+#include "simd.h"
+
+namespace simd
+{
+    // Histogram over [min, max) with one sub-histogram per SIMD lane, so the
+    // lanes of a block never increment the same counter. Values outside the
+    // range land in the first / last bin. Holds no SIMD state itself, so it can
+    // be returned from worker threads and merged.
+    template<typename E, typename T = float>
+    class histogram
+    {
+    public:
+        enum { lanes = simd::lanes<E, T>::count };
+
+        histogram() : _bins(0), _min(0), _max(0) {}
+        histogram(size_t bins, T min, T max)
+            : _bins(bins), _min(min), _max(max), _counts(lanes * (bins + 1), 0)
+        {
+            assert(bins > 0 && max > min);
+        }
+
+        size_t bins() const { return _bins; }
+        T min() const { return _min; }
+        T max() const { return _max; }
+
+        // Bin index math with pre-broadcast constants, meant to live on the stack
+        // of the loop that feeds it
+        class binner
+        {
+        public:
+            explicit binner(histogram& owner)
+                : _owner(owner), _scale(T(owner._bins) / (owner._max - owner._min)),
+                  _offset(-owner._min * T(owner._bins) / (owner._max - owner._min)),
+                  _zero(T(0)), _last(T(owner._bins - 1)), _discard(T(owner._bins))
+            {}
+
+            template<int K>
+            FORCEINLINE void add(const vector<E, T, K>& v)
+            {
+                count(clamp(v));
+            }
+
+            // Lanes outside of mask go to a discard bin past the last one
+            template<int K>
+            FORCEINLINE void add(const vector<E, T, K>& v, const vector<E, T, K>& mask)
+            {
+                vector<E, T, K> discard;
+                for (int i = 0; i < K; i++) discard.assign(i, _discard.value());
+                count(vector<E, T, K>::select(mask, clamp(v), discard));
+            }
+
+        private:
+            template<int K>
+            FORCEINLINE vector<E, T, K> clamp(const vector<E, T, K>& v) const
+            {
+                vector<E, T, K> zero, last;
+                for (int i = 0; i < K; i++)
+                {
+                    zero.assign(i, _zero.value());
+                    last.assign(i, _last.value());
+                }
+                auto idx = v.multiply_add(_scale, _offset);
+                return vector<E, T, K>::min(vector<E, T, K>::max(idx, zero), last);
+            }
+
+            // Bin indices are computed and clamped in registers, only the increments are per lane
+            template<int K>
+            FORCEINLINE void count(const vector<E, T, K>& idx)
+            {
+                const auto stride = _owner._bins + 1;
+                unsigned int* counts = _owner._counts.data();
+
+                T values[lanes];
+                for (int i = 0; i < K; i++)
+                {
+                    simd::lanes<E, T>::extract(idx.fetch(i), values);
+                    for (int lane = 0; lane < lanes; lane++)
+                        counts[lane * stride + (size_t)values[lane]]++;
+                }
+            }
+
+            histogram& _owner;
+            broadcast<E, T> _scale, _offset;
+            broadcast<E, T> _zero, _last, _discard;
+        };
+
+        binner make_binner() { return binner(*this); }
+
+        void merge(const histogram& other)
+        {
+            assert(other._bins == _bins && other._min == _min && other._max == _max);
+            for (size_t i = 0; i < _counts.size(); i++)
+                _counts[i] += other._counts[i];
+        }
+
+        // Lanes summed up, one count per bin
+        std::vector<size_t> counts() const
+        {
+            std::vector<size_t> result(_bins, 0);
+            for (int lane = 0; lane < lanes; lane++)
+                for (size_t bin = 0; bin < _bins; bin++)
+                    result[bin] += _counts[lane * (_bins + 1) + bin];
+            return result;
+        }
+
+    private:
+        size_t _bins;
+        T _min, _max;
+        std::vector<unsigned int> _counts; // lanes x (bins + discard bin)
+    };
+}
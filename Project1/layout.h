@@ -0,0 +1,92 @@
+#pragma once
+
+#include "core.h"
+
+namespace simd
+{
+    // Memory layouts a transformation can read from and write to.
+    // Plain element types (float3, float2, ...) mean interleaved AoS.
+
+    // Planar: every component in its own plane of `count` scalars, back to back,
+    // i.e. x[count] y[count] z[count]
+    template<class D>
+    struct soa {};
+
+    // Interleaved blocks of N elements: x[N] y[N] z[N] x[N] y[N] z[N] ...
+    template<class D, int N>
+    struct aosoa {};
+
+    // D embedded in wider records (i.e. position inside a vertex struct), records are
+    // STRIDE bytes apart and D starts OFFSET bytes into each. STRIDE of 0 means both
+    // are only known at runtime, see transformation::set_input_stride(). Input only.
+    template<class D, int STRIDE = 0, int OFFSET = 0>
+    struct strided {};
+
+    // How the iterator reaches the elements of a layout
+    enum layout_access
+    {
+        INTERLEAVED, // Whole registers, shuffled apart by gather / scatter
+        PLANAR,      // One register per component
+        STRIDED,     // One register per component, picked lane by lane from records
+    };
+
+    // offset() gives the position, in scalars, of `component` of element `first`
+    // in a buffer of `count` elements, each made of ELEMENTS scalars
+    template<class D>
+    struct layout_traits
+    {
+        typedef D element_type;
+        enum { access = INTERLEAVED };
+        enum { planar = 0 };
+        enum { group = 1 };
+
+        template<int ELEMENTS>
+        static size_t offset(size_t first, int component, size_t count)
+        {
+            return first * ELEMENTS + component;
+        }
+    };
+
+    template<class D>
+    struct layout_traits<soa<D>>
+    {
+        typedef D element_type;
+        enum { access = PLANAR };
+        enum { planar = 1 };
+        enum { group = 1 };
+
+        template<int ELEMENTS>
+        static size_t offset(size_t first, int component, size_t count)
+        {
+            return component * count + first;
+        }
+    };
+
+    template<class D, int N>
+    struct layout_traits<aosoa<D, N>>
+    {
+        typedef D element_type;
+        enum { access = PLANAR };
+        enum { planar = 1 };
+        enum { group = N };
+
+        template<int ELEMENTS>
+        static size_t offset(size_t first, int component, size_t count)
+        {
+            return (first / N) * N * ELEMENTS + component * N + first % N;
+        }
+    };
+
+    template<class D, int STRIDE, int OFFSET>
+    struct layout_traits<strided<D, STRIDE, OFFSET>>
+    {
+        typedef D element_type;
+        enum { access = STRIDED };
+        enum { planar = 1 };
+        enum { group = 1 };
+        enum { stride = STRIDE };
+        enum { offset = OFFSET };
+
+        static_assert(STRIDE == 0 || STRIDE >= OFFSET + (int)sizeof(D), "Element does not fit in the record!");
+    };
+}
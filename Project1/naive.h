@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cmath>
+
 #include "core.h"
+#include "formats.h"
 
 namespace simd
 {
@@ -9,6 +12,8 @@ namespace simd
     {
         static bool can_run() { return true; }
 
+        enum { registers = SIMD_VECTOR_REGISTERS };
+
         template<typename T>
         struct native_simd
         {
@@ -33,6 +38,22 @@ namespace simd
             {
                 return other;
             }
+
+            FORCEINLINE static T fmadd(const T& a, const T& b, const T& c)
+            {
+                return a * b + c;
+            }
+
+            FORCEINLINE static T min(const T& a, const T& b) { return a < b ? a : b; }
+            FORCEINLINE static T max(const T& a, const T& b) { return a > b ? a : b; }
+            FORCEINLINE static T sqrt(const T& a) { return std::sqrt(a); }
+
+            // Masks are plain 1 / 0 values
+            FORCEINLINE static T greater(const T& a, const T& b) { return a > b ? T(1) : T(0); }
+            FORCEINLINE static T less(const T& a, const T& b) { return a < b ? T(1) : T(0); }
+            FORCEINLINE static T select(const T& mask, const T& a, const T& b) { return mask != T(0) ? a : b; }
+            FORCEINLINE static int movemask(const T& mask) { return mask != T(0) ? 1 : 0; }
+            FORCEINLINE static T mask_from_bits(int bits) { return (bits & 1) ? T(1) : T(0); }
         };
 
         template<class T, unsigned int START, unsigned int GAP>
@@ -48,6 +69,12 @@ namespace simd
             }
         };
 
+        // One scalar per register, the same for any scalar type
+        template<unsigned int START, unsigned int GAP>
+        struct gather_utils<double, START, GAP> : gather_utils<float, START, GAP> {};
+        template<unsigned int START, unsigned int GAP>
+        struct gather_utils<uint8_t, START, GAP> : gather_utils<float, START, GAP> {};
+
         template<class T, unsigned int START, unsigned int GAP>
         struct scatter_utils {};
 
@@ -60,5 +87,70 @@ namespace simd
                 output_block.assign(START, curr_var.fetch(0));
             }
         };
+
+        template<unsigned int START, unsigned int GAP>
+        struct scatter_utils<double, START, GAP> : scatter_utils<float, START, GAP> {};
+        template<unsigned int START, unsigned int GAP>
+        struct scatter_utils<uint8_t, START, GAP> : scatter_utils<float, START, GAP> {};
+
+        template<class T, unsigned int COMPONENTS>
+        struct strided_utils {};
+
+        template<unsigned int COMPONENTS>
+        struct strided_utils<float, COMPONENTS>
+        {
+            template<unsigned int STRIDE, bool FITS, class VT>
+            static void gather(const float* base, VT& result)
+            {
+                for (unsigned int i = 0; i < COMPONENTS; i++)
+                    result.assign(i, base[i]);
+            }
+
+            template<class VT>
+            static void gather(const float* base, size_t stride, bool fits, VT& result)
+            {
+                gather<0, false>(base, result);
+            }
+        };
+
+        template<class T, unsigned int COMPONENTS>
+        struct indexed_utils {};
+
+        // Record indices[0], records stride scalars apart
+        template<unsigned int COMPONENTS>
+        struct indexed_utils<float, COMPONENTS>
+        {
+            template<class VT>
+            static void gather(const float* base, const uint32_t* indices, size_t stride, VT& result)
+            {
+                strided_utils<float, COMPONENTS>::gather(base + indices[0] * stride, stride, false, result);
+            }
+        };
+
+        // BT.601 limited range YUV to RGB in 6-bit fixed point, the reference for every
+        // engine. y * 257 * 18997 / 65536 is 64 * 1.164 * y. The SIMD engines saturate their
+        // 16-bit sums, which only ever happens to values that clamp to 255 here anyway.
+        struct yuv_utils
+        {
+            FORCEINLINE static void to_rgb(uint8_t y, uint8_t u, uint8_t v, uint8_t& r, uint8_t& g, uint8_t& b)
+            {
+                const int luma = (y * 257 * 18997) >> 16;
+                const int d = u - 128, e = v - 128;
+                r = clamp((luma + 102 * e - 1160) >> 6);
+                g = clamp((luma - 25 * d - 52 * e - 1160) >> 6);
+                b = clamp((luma + 129 * d - 1160) >> 6);
+            }
+
+        private:
+            FORCEINLINE static uint8_t clamp(int x) { return (uint8_t)(x < 0 ? 0 : x > 255 ? 255 : x); }
+        };
+
+        // 16-bit storage formats, one scalar at a time
+        template<class F>
+        struct format_utils
+        {
+            FORCEINLINE static void encode(float value, uint16_t* target) { *target = F::encode(value); }
+            FORCEINLINE static float decode(const uint16_t* source) { return F::decode(*source); }
+        };
     };
 }
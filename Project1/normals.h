@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+
+#include "core.h"
+#include "simd.h"
+#include "stencil.h"
+
+namespace simd
+{
+    // Surface normals of an organized point cloud from central differences,
+    // n = normalize((down - up) x (right - left)), pointing back at the camera.
+    // Pixels where the center or any neighbour has no depth get a zero normal.
+    template<typename E, typename T = float>
+    class normal_kernel
+    {
+    public:
+        typedef broadcast<E, T> broadcast_t;
+
+        normal_kernel() : _zero(T(0)) {}
+
+        template<int K>
+        FORCEINLINE void apply(const std::array<vector<E, T, K>, 3>& center,
+                               const std::array<vector<E, T, K>, 3>& up, const std::array<vector<E, T, K>, 3>& down,
+                               const std::array<vector<E, T, K>, 3>& left, const std::array<vector<E, T, K>, 3>& right,
+                               vector<E, T, K>& nx, vector<E, T, K>& ny, vector<E, T, K>& nz) const
+        {
+            typedef vector<E, T, K> V;
+
+            V ax = right[0], ay = right[1], az = right[2];
+            V bx = down[0], by = down[1], bz = down[2];
+            ax = ax - left[0]; ay = ay - left[1]; az = az - left[2];
+            bx = bx - up[0]; by = by - up[1]; bz = bz - up[2];
+
+            V cx = by * az, cy = bz * ax, cz = bx * ay;
+            cx = cx - bz * ay;
+            cy = cy - bx * az;
+            cz = cz - by * ax;
+
+            V length = cx * cx;
+            length = V::sqrt(length + cy * cy + cz * cz);
+
+            // Lanes with a missing depth or a degenerate neighbourhood fail one test
+            const auto valid = V::min(V::min(V::min(center[2], up[2]), V::min(down[2], left[2])),
+                                      V::min(right[2], length)).greater(_zero);
+            const V zero;
+            nx = V::select(valid, cx / length, zero);
+            ny = V::select(valid, cy / length, zero);
+            nz = V::select(valid, cz / length, zero);
+        }
+
+    private:
+        broadcast_t _zero;
+    };
+}
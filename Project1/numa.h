@@ -0,0 +1,225 @@
+#pragma once
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <iostream>
+#include <sstream>
+#include <stdlib.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "core.h"
+
+namespace simd
+{
+    // NUMA nodes and the CPUs of each that this process may run on. Linux reads the node
+    // lists from sysfs, anything else (or a failed read) is one node of every CPU, so
+    // the policies below turn into plain parallel_apply on single-node machines.
+    class numa_topology
+    {
+    public:
+        numa_topology()
+        {
+#ifndef _WIN32
+            std::vector<int> allowed;
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            if (sched_getaffinity(0, sizeof(set), &set) == 0)
+                for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+                    if (CPU_ISSET(cpu, &set)) allowed.push_back(cpu);
+
+            for (int node : read_list("/sys/devices/system/node/online"))
+            {
+                std::vector<int> cpus;
+                for (int cpu : read_list("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"))
+                    if (std::find(allowed.begin(), allowed.end(), cpu) != allowed.end()) cpus.push_back(cpu);
+                if (!cpus.empty()) _nodes.push_back(cpus);
+            }
+            if (_nodes.empty() && !allowed.empty()) _nodes.push_back(allowed);
+#endif
+            if (_nodes.empty())
+            {
+                std::vector<int> cpus(std::max(1u, std::thread::hardware_concurrency()));
+                for (size_t i = 0; i < cpus.size(); i++) cpus[i] = (int)i;
+                _nodes.push_back(cpus);
+            }
+        }
+
+        // Detected once per process
+        static const numa_topology& system()
+        {
+            static const numa_topology topology;
+            return topology;
+        }
+
+        size_t nodes() const { return _nodes.size(); }
+        bool single_node() const { return _nodes.size() == 1; }
+        const std::vector<int>& cpus(size_t node) const { return _nodes[node]; }
+
+        size_t cpu_count() const
+        {
+            size_t result = 0;
+            for (auto&& n : _nodes) result += n.size();
+            return result;
+        }
+
+    private:
+        // sysfs list format, i.e. "0-3,8-11"
+        static std::vector<int> read_list(const std::string& filename)
+        {
+            std::vector<int> result;
+            std::ifstream file(filename);
+            std::string list, range;
+            if (!std::getline(file, list)) return result;
+            std::stringstream ranges(list);
+            while (std::getline(ranges, range, ','))
+            {
+                int first = 0, last = 0;
+                const char* text = range.c_str();
+                char* end = nullptr;
+                first = last = (int)strtol(text, &end, 10);
+                if (end == text) continue;
+                if (*end == '-') last = (int)strtol(end + 1, nullptr, 10);
+                for (int i = first; i <= last; i++) result.push_back(i);
+            }
+            return result;
+        }
+
+        std::vector<std::vector<int>> _nodes;
+    };
+
+    // Pins the calling thread to one CPU, false where the platform or the process
+    // affinity does not allow it (the thread then runs wherever the OS puts it)
+    inline bool pin_thread(int cpu)
+    {
+#ifdef _WIN32
+        if (cpu < 0 || cpu >= (int)(8 * sizeof(DWORD_PTR))) return false;
+        return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu) != 0;
+#else
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#endif
+    }
+
+    // One worker's share of a block range: the blocks it processes, the CPU it is pinned
+    // to and the node that CPU belongs to
+    struct numa_slice
+    {
+        size_t node;
+        int cpu;
+        size_t first_block;
+        size_t blocks;
+    };
+
+    // Splits blocks between nodes in proportion to their CPUs, then evenly between one
+    // worker per CPU of each node (or threads_per_node of them). Slices of a node are
+    // contiguous, so a node's share of a buffer is one range of pages.
+    inline std::vector<numa_slice> numa_partition(size_t blocks, const numa_topology& topology = numa_topology::system(),
+                                                  unsigned int threads_per_node = 0)
+    {
+        std::vector<numa_slice> result;
+        const size_t cpus = topology.cpu_count();
+        size_t first = 0, cpus_before = 0;
+        for (size_t node = 0; node < topology.nodes(); node++)
+        {
+            const auto& node_cpus = topology.cpus(node);
+            cpus_before += node_cpus.size();
+            const size_t end = blocks * cpus_before / cpus;
+            const size_t node_blocks = end - first;
+
+            size_t workers = threads_per_node ? std::min<size_t>(threads_per_node, node_cpus.size()) : node_cpus.size();
+            workers = std::max<size_t>(1, std::min(workers, node_blocks));
+            for (size_t w = 0; w < workers; w++)
+            {
+                const size_t count = node_blocks / workers + (w < node_blocks % workers ? 1 : 0);
+                if (count) result.push_back(numa_slice{ node, node_cpus[w], first, count });
+                first += count;
+            }
+        }
+        return result;
+    }
+
+    // f(slice) on one pinned thread per slice, results in slice order
+    template<class F>
+    auto numa_run(const std::vector<numa_slice>& plan, F f) -> std::vector<decltype(f(plan[0]))>
+    {
+        std::vector<decltype(f(plan[0]))> results(plan.size());
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i < plan.size(); i++)
+        {
+            workers.emplace_back([&plan, &f, &results, i]()
+            {
+                pin_thread(plan[i].cpu);
+                results[i] = f(plan[i]);
+            });
+        }
+        for (auto&& w : workers) w.join();
+        return results;
+    }
+
+    // Frame buffer whose pages are not written at allocation (std::vector would zero them
+    // all from the allocating thread, placing them on its node). first_touch() then has
+    // every worker of a plan write its own share first, which is what places a page.
+    template<class T>
+    class numa_buffer
+    {
+    public:
+        explicit numa_buffer(size_t count) : _data(new T[count]), _count(count) {}
+
+        T* data() { return _data.get(); }
+        const T* data() const { return _data.get(); }
+        size_t size() const { return _count; }
+
+        // The buffer holds blocks iterator steps, evenly sized. Every worker of plan fills
+        // its blocks' share from source, or with zeros.
+        void first_touch(const std::vector<numa_slice>& plan, size_t blocks, const T* source = nullptr)
+        {
+            numa_run(plan, [&](const numa_slice& s)
+            {
+                const size_t first = _count * s.first_block / blocks;
+                const size_t last = _count * (s.first_block + s.blocks) / blocks;
+                if (source) std::copy(source + first, source + last, _data.get() + first);
+                else std::fill(_data.get() + first, _data.get() + last, T());
+                return last - first;
+            });
+        }
+
+    private:
+        std::unique_ptr<T[]> _data;
+        size_t _count;
+    };
+
+    // parallel_apply over the slices of a plan, each slice on a thread pinned to a CPU
+    // of its node. With buffers first touched through the same plan, every worker reads
+    // and writes memory local to its node.
+    template<class TR, class F>
+    auto numa_apply(TR& t, F work, const std::vector<numa_slice>& plan) -> std::vector<decltype(work(t))>
+    {
+        typedef decltype(work(t)) result_type;
+        if (!TR::supported())
+        {
+            std::cout << "Engine not supported!" << std::endl;
+            return std::vector<result_type>(plan.size());
+        }
+        assert(t.can_split() || plan.size() == 1);
+        return numa_run(plan, [&t, &work](const numa_slice& s)
+        {
+            auto slice = t.slice(s.first_block, s.blocks);
+            return work(slice);
+        });
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <thread>
+#include <vector>
+
+#include "core.h"
+
+namespace simd
+{
+    // Splits the block range of a transformation into one slice per thread and
+    // runs work(slice) on each. Whatever work returns per slice (i.e. a reduced
+    // summary) is handed back in slice order, for the caller to merge. In-place
+    // transformations that shrink their elements run as a single slice.
+    template<class TR, class F>
+    auto parallel_apply(TR& t, F work, unsigned int threads = std::thread::hardware_concurrency())
+        -> std::vector<decltype(work(t))>
+    {
+        typedef decltype(work(t)) result_type;
+
+        if (!threads || !t.can_split()) threads = 1;
+        const auto blocks = t.blocks();
+        if (threads > blocks) threads = blocks ? (unsigned int)blocks : 1;
+
+        std::vector<result_type> results(threads);
+        if (!TR::supported())
+        {
+            std::cout << "Engine not supported!" << std::endl;
+            return results;
+        }
+
+        std::vector<std::thread> workers;
+        size_t first = 0;
+        for (unsigned int i = 0; i < threads; i++)
+        {
+            const auto count = blocks / threads + (i < blocks % threads ? 1 : 0);
+            auto slice = t.slice(first, count);
+            first += count;
+
+            workers.emplace_back([slice, &work, &results, i]() mutable
+            {
+                results[i] = work(slice);
+            });
+        }
+        for (auto&& w : workers) w.join();
+
+        return results;
+    }
+}
@@ -0,0 +1,267 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core.h"
+
+namespace simd
+{
+    // Bounded single-producer / single-consumer ring of frame pointers.
+    // Frames are never copied, only ownership of the pointer moves between stages.
+    template<class F, unsigned int N>
+    class frame_ring
+    {
+        static_assert(N && (N & (N - 1)) == 0, "Ring capacity must be a power of two!");
+
+    public:
+        frame_ring() : _head(0), _tail(0) {}
+
+        bool push(F* frame)
+        {
+            const auto tail = _tail.load(std::memory_order_relaxed);
+            if (tail - _head.load(std::memory_order_acquire) == N) return false;
+
+            _frames[tail & (N - 1)] = frame;
+            _tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool pop(F*& frame)
+        {
+            const auto head = _head.load(std::memory_order_relaxed);
+            if (head == _tail.load(std::memory_order_acquire)) return false;
+
+            frame = _frames[head & (N - 1)];
+            _head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        size_t size() const
+        {
+            return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire);
+        }
+
+        enum { capacity = N };
+
+    private:
+        // Producer and consumer indices a cache line apart, padded by hand rather than
+        // with alignas, which plain new does not honor before C++17
+        enum { cache_line = 64 };
+
+        F* _frames[N];
+        char _frames_pad[cache_line];
+        std::atomic<size_t> _head;
+        char _head_pad[cache_line - sizeof(std::atomic<size_t>)];
+        std::atomic<size_t> _tail;
+        char _tail_pad[cache_line - sizeof(std::atomic<size_t>)];
+    };
+
+    struct stage_stats
+    {
+        std::string name;
+        size_t queue_depth;     // Frames waiting in front of the stage
+        size_t frames;          // Frames processed so far
+        size_t dropped;         // Frames finished after stop() with the output ring full
+        double average_latency; // Microseconds spent in the stage per frame
+        double max_latency;
+    };
+
+    // Streams frames through a chain of stages, each running on its own thread.
+    // Stage i consumes from ring i and produces into ring i + 1, the last ring
+    // holds completed frames until the caller picks them up with receive().
+    // A stage with nothing to do, or no room downstream, sleeps until that changes.
+    template<class F, unsigned int DEPTH = 8>
+    class frame_pipeline
+    {
+    public:
+        typedef std::function<void(F&)> stage_action;
+
+        frame_pipeline() : _running(false), _output(new channel()) {}
+        ~frame_pipeline() { stop(); }
+
+        frame_pipeline(const frame_pipeline&) = delete;
+        frame_pipeline& operator=(const frame_pipeline&) = delete;
+
+        void add_stage(const std::string& name, stage_action action)
+        {
+            assert(!_running && "Stages must be added before the pipeline is started!");
+            _stages.emplace_back(new stage(name, action));
+        }
+
+        void start()
+        {
+            assert(!_stages.empty());
+            if (_running) return;
+            _running = true;
+
+            for (size_t i = 0; i < _stages.size(); i++)
+            {
+                auto next = (i + 1 < _stages.size()) ? &_stages[i + 1]->input : _output.get();
+                auto upstream = i ? _stages[i - 1].get() : nullptr;
+                _stages[i]->finished = false;
+                _stages[i]->worker = std::thread(&frame_pipeline::run, this, _stages[i].get(), upstream, next);
+            }
+        }
+
+        // Drains every frame already submitted and joins the stage threads. Completed
+        // frames stay in the output ring for receive(); those finished once it is full
+        // are dropped (see stage_stats::dropped), so stop() never waits on the caller.
+        void stop()
+        {
+            if (!_running) return;
+            _running = false;
+            _stages.front()->input.notify();
+            _output->notify();
+            for (auto&& s : _stages) s->worker.join();
+        }
+
+        // Non-blocking, returns false when the first stage is saturated
+        bool submit(F* frame)
+        {
+            if (!_stages.front()->input.ring.push(frame)) return false;
+            _stages.front()->input.notify();
+            return true;
+        }
+
+        // Non-blocking, returns false when no frame has completed yet
+        bool receive(F*& frame)
+        {
+            if (!_output->ring.pop(frame)) return false;
+            _output->notify();
+            return true;
+        }
+
+        // Waits up to timeout for a completed frame
+        template<class R, class P>
+        bool receive(F*& frame, const std::chrono::duration<R, P>& timeout)
+        {
+            if (receive(frame)) return true;
+            _output->wait_for(timeout, [this]() { return _output->ring.size() != 0; });
+            return receive(frame);
+        }
+
+        std::vector<stage_stats> stats() const
+        {
+            std::vector<stage_stats> result;
+            for (auto&& s : _stages)
+            {
+                const auto frames = s->frames.load();
+                const auto total = s->total_latency.load();
+                result.push_back({ s->name, s->input.ring.size(), frames, s->dropped.load(),
+                                   frames ? total / 1000.0 / frames : 0.0,
+                                   s->max_latency.load() / 1000.0 });
+            }
+            return result;
+        }
+
+        template<class S>
+        void print(S& s) const
+        {
+            for (auto&& st : stats())
+            {
+                s << st.name << ":\tqueue " << st.queue_depth << "/" << DEPTH
+                  << "\t" << st.frames << " frames\t"
+                  << st.average_latency << " micro avg\t"
+                  << st.max_latency << " micro max";
+                if (st.dropped) s << "\t" << st.dropped << " dropped";
+                s << "\n";
+            }
+        }
+
+    private:
+        // A ring and what its two ends sleep on. The ring stays lock-free, the mutex only
+        // orders a change against a thread checking its wait condition, so that no
+        // wake-up is lost between the check and the wait.
+        struct channel
+        {
+            frame_ring<F, DEPTH> ring;
+            std::mutex mutex;
+            std::condition_variable changed; // A frame came or went, the producer finished, or stop()
+
+            void notify()
+            {
+                { std::lock_guard<std::mutex> lock(mutex); }
+                changed.notify_all();
+            }
+
+            template<class P>
+            void wait(P ready)
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, ready);
+            }
+
+            template<class R, class PE, class P>
+            void wait_for(const std::chrono::duration<R, PE>& timeout, P ready)
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait_for(lock, timeout, ready);
+            }
+        };
+
+        struct stage
+        {
+            stage(const std::string& n, stage_action a)
+                : name(n), action(a), finished(false), frames(0), dropped(0), total_latency(0), max_latency(0) {}
+
+            std::string name;
+            stage_action action;
+            channel input;
+            std::thread worker;
+            std::atomic<bool> finished;
+            std::atomic<size_t> frames;
+            std::atomic<size_t> dropped;
+            std::atomic<long long> total_latency; // Nanoseconds
+            std::atomic<long long> max_latency;
+        };
+
+        void run(stage* s, const stage* upstream, channel* next)
+        {
+            auto drained = [this, upstream]() { return upstream ? upstream->finished.load() : !_running.load(); };
+            const bool last = next == _output.get();
+
+            F* frame = nullptr;
+            for (;;)
+            {
+                // Read the exit condition before trying the ring, so a frame pushed
+                // right before the upstream stage finished is never left behind
+                const bool done = drained();
+                if (!s->input.ring.pop(frame))
+                {
+                    if (done) break;
+                    s->input.wait([&]() { return s->input.ring.size() != 0 || drained(); });
+                    continue;
+                }
+                s->input.notify();
+
+                const auto start = std::chrono::high_resolution_clock::now();
+                s->action(*frame);
+                const auto end = std::chrono::high_resolution_clock::now();
+
+                const long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+                s->total_latency += ns;
+                if (ns > s->max_latency.load()) s->max_latency = ns;
+                s->frames++;
+
+                // Only this thread pushes into next, room it sees stays there
+                next->wait([&]() { return next->ring.size() < DEPTH || (last && !_running.load()); });
+                if (next->ring.push(frame)) next->notify();
+                else s->dropped++;
+            }
+            s->finished = true;
+            next->notify();
+        }
+
+        std::atomic<bool> _running;
+        std::vector<std::unique_ptr<stage>> _stages;
+        std::unique_ptr<channel> _output;
+    };
+}
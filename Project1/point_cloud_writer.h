@@ -0,0 +1,234 @@
+#pragma once
+
+#include <initializer_list>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#include "core.h"
+#include "simd.h"
+
+namespace simd
+{
+    enum cloud_format
+    {
+        PLY_BINARY, // binary_little_endian 1.0, one vertex element
+        PCD_BINARY, // PCD v0.7, DATA binary, unorganized (HEIGHT 1)
+    };
+
+    enum field_type
+    {
+        FIELD_FLOAT,
+        FIELD_UINT8,
+        FIELD_UINT16,
+        FIELD_UINT32,
+        FIELD_INT32,
+    };
+
+    struct cloud_field
+    {
+        const char* name;
+        field_type type;
+    };
+
+    // Fields of one point record, in memory order and without gaps, so the bytes of the
+    // scattered output go to the file as they are. Padding is just another field.
+    class cloud_layout
+    {
+    public:
+        cloud_layout(std::initializer_list<cloud_field> fields) : _fields(fields) {}
+
+        static cloud_layout xyz() { return { { "x", FIELD_FLOAT }, { "y", FIELD_FLOAT }, { "z", FIELD_FLOAT } }; }
+
+        const std::vector<cloud_field>& fields() const { return _fields; }
+
+        size_t stride() const
+        {
+            size_t result = 0;
+            for (auto&& f : _fields) result += size_of(f.type);
+            return result;
+        }
+
+        static size_t size_of(field_type type)
+        {
+            switch (type)
+            {
+            case FIELD_UINT8: return 1;
+            case FIELD_UINT16: return 2;
+            default: return 4;
+            }
+        }
+
+    private:
+        std::vector<cloud_field> _fields;
+    };
+
+    // Binary PLY / PCD recording without per-point formatting. The header is written
+    // once with a fixed-width point count, records are queued by pointer and go out
+    // with one writev() per flush, straight from the transformation's output buffer,
+    // and close() rewrites the header with the final count. Nothing is copied, so
+    // queued records must stay untouched until the next flush() or close().
+    // Platforms without writev() fall back to one fwrite() per queued buffer.
+    class point_cloud_writer
+    {
+    public:
+        enum { max_queued = 64 }; // Buffers per writev(), well under any IOV_MAX
+
+        point_cloud_writer(const char* filename, cloud_format format, const cloud_layout& layout)
+            : _format(format), _layout(layout), _points(0), _failed(false)
+        {
+#ifdef _WIN32
+            _file = fopen(filename, "wb");
+            _failed = !_file;
+#else
+            _file = ::open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            _failed = _file < 0;
+#endif
+            _header = header(0);
+            queue(_header.data(), _header.size());
+        }
+        ~point_cloud_writer() { close(); }
+
+        point_cloud_writer(const point_cloud_writer&) = delete;
+        point_cloud_writer& operator=(const point_cloud_writer&) = delete;
+
+        bool good() const { return !_failed; }
+        size_t points() const { return _points; }
+
+        // count records of layout().stride() bytes each
+        void write(const void* records, size_t count)
+        {
+            queue(records, count * _layout.stride());
+            _points += count;
+        }
+
+        // Output of the blocks a transformation (or a slice of one) covers, its output
+        // elements must be the layout's records
+        template<class TR>
+        void write(const TR& t)
+        {
+            typedef typename TR::output_element element;
+            assert(sizeof(element) == _layout.stride());
+            const auto output = t.output_blocks();
+            write(output.data(), output.size() * sizeof(typename TR::output_scalar) / sizeof(element));
+        }
+
+        bool flush()
+        {
+            if (_queue.empty()) return good();
+            if (good())
+            {
+#ifdef _WIN32
+                for (auto&& b : _queue)
+                    _failed |= fwrite(b.first, 1, b.second, _file) != b.second;
+#else
+                std::vector<iovec> pending(_queue.size());
+                for (size_t i = 0; i < _queue.size(); i++)
+                    pending[i] = iovec{ const_cast<void*>(_queue[i].first), _queue[i].second };
+                // A short write leaves the rest of the first unfinished buffer and the ones after it
+                for (iovec* next = pending.data(), *end = next + pending.size(); next != end && good();)
+                {
+                    ssize_t written = ::writev(_file, next, (int)(end - next));
+                    if (written < 0) { _failed = true; break; }
+                    for (; next != end && (size_t)written >= next->iov_len; next++)
+                        written -= next->iov_len;
+                    if (next != end)
+                    {
+                        next->iov_base = (char*)next->iov_base + written;
+                        next->iov_len -= written;
+                    }
+                }
+#endif
+            }
+            _queue.clear();
+            return good();
+        }
+
+        // Flushes and writes the final point count into the header
+        bool close()
+        {
+            if (!is_open()) return good();
+            flush();
+            const std::string final_header = header(_points);
+            assert(final_header.size() == _header.size());
+#ifdef _WIN32
+            _failed |= fseek(_file, 0, SEEK_SET) != 0 ||
+                       fwrite(final_header.data(), 1, final_header.size(), _file) != final_header.size();
+            _failed |= fclose(_file) != 0;
+            _file = nullptr;
+#else
+            _failed |= ::pwrite(_file, final_header.data(), final_header.size(), 0) != (ssize_t)final_header.size();
+            _failed |= ::close(_file) != 0;
+            _file = -1;
+#endif
+            return good();
+        }
+
+    private:
+#ifdef _WIN32
+        bool is_open() const { return _file != nullptr; }
+#else
+        bool is_open() const { return _file >= 0; }
+#endif
+
+        void queue(const void* data, size_t bytes)
+        {
+            if (!bytes) return;
+            _queue.push_back(std::make_pair(data, bytes));
+            if (_queue.size() == max_queued) flush();
+        }
+
+        // Point counts are zero padded to 10 digits, so the header keeps its length
+        std::string header(size_t points) const
+        {
+            char count[16];
+            snprintf(count, sizeof(count), "%010llu", (unsigned long long)points);
+
+            std::string result;
+            if (_format == PLY_BINARY)
+            {
+                static const char* const names[] = { "float", "uchar", "ushort", "uint", "int" };
+                result = "ply\nformat binary_little_endian 1.0\nelement vertex " + std::string(count) + "\n";
+                for (auto&& f : _layout.fields())
+                    result += "property " + std::string(names[f.type]) + " " + f.name + "\n";
+                result += "end_header\n";
+            }
+            else
+            {
+                static const char types[] = { 'F', 'U', 'U', 'U', 'I' };
+                std::string fields, sizes, kinds, counts;
+                for (auto&& f : _layout.fields())
+                {
+                    fields += std::string(" ") + f.name;
+                    sizes += " " + std::to_string(cloud_layout::size_of(f.type));
+                    kinds += std::string(" ") + types[f.type];
+                    counts += " 1";
+                }
+                result = "# .PCD v0.7 - Point Cloud Data file format\nVERSION 0.7\nFIELDS" + fields +
+                         "\nSIZE" + sizes + "\nTYPE" + kinds + "\nCOUNT" + counts +
+                         "\nWIDTH " + count + "\nHEIGHT 1\nVIEWPOINT 0 0 0 1 0 0 0\nPOINTS " + count + "\nDATA binary\n";
+            }
+            return result;
+        }
+
+        cloud_format _format;
+        cloud_layout _layout;
+        size_t _points;
+        bool _failed;
+#ifdef _WIN32
+        FILE* _file;
+#else
+        int _file;
+#endif
+        std::string _header; // Queued first, so it has to outlive the first flush
+        std::vector<std::pair<const void*, size_t>> _queue;
+    };
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "core.h"
+#include "simd.h"
+#include "rigid_transform.h"
+
+namespace simd
+{
+    // Pinhole camera model, same fields as rs2_intrinsics
+    struct pinhole
+    {
+        float width;
+        float height;
+        float ppx;
+        float ppy;
+        float fx;
+        float fy;
+    };
+
+    // Extrinsics followed by pinhole projection into normalized (u, v),
+    // with the intrinsics folded into one scale and one offset per axis
+    template<typename E, typename T = float>
+    class projection_kernel
+    {
+    public:
+        typedef broadcast<E, T> broadcast_t;
+
+        projection_kernel() {}
+        projection_kernel(const rigid_transform& extrinsics, const pinhole& intrinsics)
+            : _to_point(extrinsics),
+              _scale_u(intrinsics.fx / intrinsics.width), _offset_u(intrinsics.ppx / intrinsics.width),
+              _scale_v(intrinsics.fy / intrinsics.height), _offset_v(intrinsics.ppy / intrinsics.height)
+        {}
+
+        template<int K>
+        FORCEINLINE void apply(const vector<E, T, K>& x, const vector<E, T, K>& y, const vector<E, T, K>& z,
+                               vector<E, T, K>& u, vector<E, T, K>& v) const
+        {
+            vector<E, T, K> px, py, pz;
+            _to_point.apply(x, y, z, px, py, pz);
+
+            u = (px / pz).multiply_add(_scale_u, _offset_u);
+            v = (py / pz).multiply_add(_scale_v, _offset_v);
+        }
+
+    private:
+        rigid_transform_kernel<E, T> _to_point;
+        broadcast_t _scale_u, _offset_u;
+        broadcast_t _scale_v, _offset_v;
+    };
+
+    // Same input stream projected into N cameras: every block is loaded and
+    // gathered once and then scattered into N output streams
+    template<typename T1, class D1, typename T2, class D2, int N, engine_type ET = DEFAULT>
+    class multi_transformation
+    {
+    public:
+        typedef transformation<T1, D1, T2, D2, ET> stream_type;
+        typedef typename stream_type::engine_t engine_t;
+        typedef typename stream_type::input_type input_type;
+        typedef typename stream_type::gather_type gather_type;
+        typedef typename stream_type::output_type output_type;
+
+        enum { outputs = N };
+
+        multi_transformation() {}
+        multi_transformation(T1 * input, T2 * const output[N], size_t count) { bind(input, output, count); }
+
+        void bind(T1 * input, T2 * const output[N], size_t count)
+        {
+            for (int i = 0; i < N; i++)
+                _streams[i].bind(input, output[i], count);
+        }
+
+        size_t size() const { return _streams[0].size(); }
+        size_t blocks() const { return _streams[0].blocks(); }
+
+        template<class T>
+        void apply(T action)
+        {
+            if (stream_type::supported())
+            {
+                action(*this);
+            }
+            else
+            {
+                std::cout << "Engine not supported!" << std::endl;
+            }
+        }
+
+        class iterator
+        {
+        public:
+            typedef typename stream_type::iterator stream_iterator;
+
+            FORCEINLINE iterator(multi_transformation* owner, size_t index = 0) : _owner(owner), _index(index) {}
+            FORCEINLINE iterator& operator++() { ++_index; return *this; }
+            FORCEINLINE bool operator==(const iterator& other) const { return _index == other._index; }
+            FORCEINLINE bool operator!=(const iterator& other) const { return !(*this == other); }
+
+            FORCEINLINE iterator operator*() { return *this; }
+
+            input_type load() { return stream(0).load(); }
+
+            std::array<gather_type, stream_type::elements_in> gather(const input_type& block) const
+            {
+                return stream(0).gather(block);
+            }
+
+            template<class T, class... A>
+            output_type scatter(const T& t, const A&... args) const
+            {
+                return stream(0).scatter(t, args...);
+            }
+
+            void store(int camera, const output_type& val) { stream(camera).store(val); }
+
+        private:
+            FORCEINLINE stream_iterator stream(int idx) const
+            {
+                return stream_iterator(&_owner->_streams[idx], _index);
+            }
+
+            multi_transformation* _owner;
+            size_t _index;
+        };
+
+        FORCEINLINE iterator begin() { return iterator(this); }
+        FORCEINLINE iterator end() { return iterator(this, blocks()); }
+
+    private:
+        stream_type _streams[N];
+    };
+}
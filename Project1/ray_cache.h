@@ -0,0 +1,210 @@
+#pragma once
+
+#include <vector>
+
+#include "core.h"
+#include "simd.h"
+#include "projection.h"
+#include "zip.h"
+
+namespace simd
+{
+    // Brown-Conrady lens distortion in the order of rs2_intrinsics::coeffs: k1, k2, p1, p2, k3
+    struct brown_conrady
+    {
+        float coeffs[5];
+    };
+
+    // Direction through a pixel, scaled to z = 1, so that z * ray is the point at depth z
+    struct ray
+    {
+        float x;
+        float y;
+    };
+
+    // Rays of every pixel of a camera, kept as two planes (x of all pixels, then y) and
+    // rebuilt only when the intrinsics change. Building the table is where the per-pixel
+    // divides and the iterative undistortion happen, once; deprojecting a frame is then a
+    // depth plane zipped with the ray planes and one multiply per coordinate.
+    template<engine_type ET = DEFAULT>
+    class ray_cache
+    {
+    public:
+        typedef engine<ET> engine_t;
+        typedef vector<engine_t, float, 1> vector_t;
+        typedef typename vector_t::underlying_t underlying_t;
+        typedef broadcast<engine_t, float> broadcast_t;
+
+        // Depth in, points out, rays read alongside the depth
+        template<class P>
+        using deprojection = zip_transformation<float, P, ET, stream<float, float>, stream<float, soa<ray>>>;
+
+        enum { lanes = vector_t::lanes_per_register };
+        enum { iterations = 10 }; // Fixed point steps of the undistortion, as librealsense takes
+
+        ray_cache() : _intrinsics(), _distortion(), _count(0) {}
+
+        // Rebuilds the table if intrinsics or distortion differ from the cached ones,
+        // true if it did
+        bool update(const pinhole& intrinsics, const brown_conrady& distortion = brown_conrady())
+        {
+            if (_count && same(intrinsics, distortion)) return false;
+
+            _intrinsics = intrinsics;
+            _distortion = distortion;
+            _count = (size_t)intrinsics.width * (size_t)intrinsics.height;
+            _rays.resize(_count * 2);
+            build();
+            return true;
+        }
+
+        size_t size() const { return _count; }
+        const float* x() const { return _rays.data(); }
+        const float* y() const { return _rays.data() + _count; }
+
+        static bool supported()
+        {
+            static const bool result = engine_t::can_run();
+            return result;
+        }
+
+        // size() depths in, size() points of three floats out, see deprojection for slicing
+        // the frame between threads
+        template<class P>
+        void deproject(const float* depth, P* points)
+        {
+            deprojection<P> zip;
+            bind(zip, depth, points);
+            zip.apply(deproject_app<deprojection<P>>());
+        }
+
+        template<class P>
+        void bind(deprojection<P>& zip, const float* depth, P* points)
+        {
+            assert(_count && _count % lanes == 0);
+            zip.bind(reinterpret_cast<float*>(points), _count, const_cast<float*>(depth), const_cast<float*>(x()));
+        }
+
+        template<class T>
+        struct deproject_app
+        {
+            void operator()(T& ptr)
+            {
+                for (auto i : ptr)
+                {
+                    auto z = i.template fetch<0>();
+                    auto r = i.template fetch<1>();
+                    i.store(i.scatter(r[0] * z[0], r[1] * z[0], z[0]));
+                }
+            }
+        };
+
+        // Ray through pixel (u, v), the scalar reference of the table
+        static ray direction(const pinhole& intrinsics, const brown_conrady& distortion, float u, float v)
+        {
+            const float xd = (u - intrinsics.ppx) / intrinsics.fx, yd = (v - intrinsics.ppy) / intrinsics.fy;
+            const float* c = distortion.coeffs;
+            float x = xd, y = yd;
+            if (distorted(distortion))
+            {
+                for (int i = 0; i < iterations; i++)
+                {
+                    const float r2 = x * x + y * y;
+                    const float radial = 1.f + r2 * (c[0] + r2 * (c[1] + r2 * c[4]));
+                    const float dx = 2.f * c[2] * x * y + c[3] * (r2 + 2.f * x * x);
+                    const float dy = c[2] * (r2 + 2.f * y * y) + 2.f * c[3] * x * y;
+                    x = (xd - dx) / radial;
+                    y = (yd - dy) / radial;
+                }
+            }
+            return ray{ x, y };
+        }
+
+    private:
+        static bool distorted(const brown_conrady& distortion)
+        {
+            for (int i = 0; i < 5; i++)
+                if (distortion.coeffs[i] != 0.f) return true;
+            return false;
+        }
+
+        bool same(const pinhole& intrinsics, const brown_conrady& distortion) const
+        {
+            const auto& a = _intrinsics;
+            const auto& b = intrinsics;
+            if (a.width != b.width || a.height != b.height || a.ppx != b.ppx || a.ppy != b.ppy || a.fx != b.fx || a.fy != b.fy)
+                return false;
+            for (int i = 0; i < 5; i++)
+                if (_distortion.coeffs[i] != distortion.coeffs[i]) return false;
+            return true;
+        }
+
+        // Row by row, a register of columns at a time, the same arithmetic as direction()
+        void build()
+        {
+            const size_t width = (size_t)_intrinsics.width, height = (size_t)_intrinsics.height;
+            const size_t whole = supported() ? width / lanes * lanes : 0;
+            const bool undistort = distorted(_distortion);
+            const float* c = _distortion.coeffs;
+
+            // Columns as floats, to load a register of u at a time
+            std::vector<float> columns(width);
+            for (size_t u = 0; u < width; u++) columns[u] = (float)u;
+
+            const broadcast_t k1(c[0]), k2(c[1]), k3(c[4]), p1(c[2]), p2(c[3]);
+            const broadcast_t one(1.f), two(2.f);
+
+            for (size_t v = 0; v < height; v++)
+            {
+                float* row_x = _rays.data() + v * width;
+                float* row_y = row_x + _count;
+                vector_t yd;
+                yd.assign(0, broadcast_t(((float)v - _intrinsics.ppy) / _intrinsics.fy).value());
+
+                for (size_t u = 0; u < whole; u += lanes)
+                {
+                    vector_t xd(reinterpret_cast<const underlying_t*>(columns.data() + u));
+                    xd = (xd - _intrinsics.ppx) / _intrinsics.fx;
+
+                    vector_t x = xd, y = yd;
+                    if (undistort)
+                    {
+                        for (int i = 0; i < iterations; i++)
+                        {
+                            vector_t xx = x * x, yy = y * y, xy = x * y;
+                            vector_t r2 = xx + yy;
+                            vector_t radial = r2 * k3 + k2;
+                            radial = r2 * radial + k1;
+                            radial = r2 * radial + one;
+
+                            vector_t tangent_x = xx * two + r2;
+                            vector_t tangent_y = yy * two + r2;
+                            vector_t cross = xy * two;
+                            vector_t dx = cross * p1, dy = cross * p2;
+                            dx = dx + tangent_x * p2;
+                            dy = dy + tangent_y * p1;
+
+                            x = xd - dx;
+                            y = yd - dy;
+                            x = x / radial;
+                            y = y / radial;
+                        }
+                    }
+                    x.store(reinterpret_cast<underlying_t*>(row_x + u));
+                    y.store(reinterpret_cast<underlying_t*>(row_y + u));
+                }
+                for (size_t u = whole; u < width; u++)
+                {
+                    const ray r = direction(_intrinsics, _distortion, (float)u, (float)v);
+                    row_x[u] = r.x;
+                    row_y[u] = r.y;
+                }
+            }
+        }
+
+        pinhole _intrinsics;
+        brown_conrady _distortion;
+        size_t _count;
+        std::vector<float> _rays; // x plane then y plane, size() each
+    };
+}
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <limits>
+
+#include "core.h"
+#include "simd.h"
+
+namespace simd
+{
+    struct sum_op
+    {
+        template<class T> static T identity() { return T(0); }
+        template<class W, class S> FORCEINLINE static S apply(const S& a, const S& b) { return a + b; }
+        template<class T> static T apply_scalar(T a, T b) { return a + b; }
+    };
+    struct min_op
+    {
+        template<class T> static T identity() { return std::numeric_limits<T>::max(); }
+        template<class W, class S> FORCEINLINE static S apply(const S& a, const S& b) { return W::min(a, b); }
+        template<class T> static T apply_scalar(T a, T b) { return a < b ? a : b; }
+    };
+    struct max_op
+    {
+        template<class T> static T identity() { return std::numeric_limits<T>::lowest(); }
+        template<class W, class S> FORCEINLINE static S apply(const S& a, const S& b) { return W::max(a, b); }
+        template<class T> static T apply_scalar(T a, T b) { return a > b ? a : b; }
+    };
+
+    // Accumulator that stays in one engine register for the whole iterator loop,
+    // the lanes are only combined horizontally when value() is asked for
+    template<typename E, typename T, class OP>
+    class reduction
+    {
+    public:
+        typedef typename E::template native_simd<T> vectorized_wrapper;
+        typedef typename E::template native_simd<T>::representation_type simd_t;
+
+        FORCEINLINE reduction() : _acc(vectorized_wrapper::vectorize(OP::template identity<T>())) {}
+
+        template<int K>
+        FORCEINLINE void add(const vector<E, T, K>& v)
+        {
+            for (int i = 0; i < K; i++)
+                _acc = OP::template apply<vectorized_wrapper>(_acc, v.fetch(i));
+        }
+
+        // Only lanes set in mask contribute
+        template<int K>
+        FORCEINLINE void add(const vector<E, T, K>& v, const vector<E, T, K>& mask)
+        {
+            const simd_t identity = vectorized_wrapper::vectorize(OP::template identity<T>());
+            for (int i = 0; i < K; i++)
+                _acc = OP::template apply<vectorized_wrapper>(_acc, vectorized_wrapper::select(mask.fetch(i), v.fetch(i), identity));
+        }
+
+        T value() const
+        {
+            T values[lanes<E, T>::count];
+            lanes<E, T>::extract(_acc, values);
+
+            T result = values[0];
+            for (int i = 1; i < lanes<E, T>::count; i++)
+                result = OP::apply_scalar(result, values[i]);
+            return result;
+        }
+
+    private:
+        simd_t _acc;
+    };
+
+    // Masked sum kept in float lanes for up to block_steps add() calls, then carried into
+    // a double, so precision does not run out however many frames are accumulated
+    template<typename E, typename T = float>
+    class blocked_sum
+    {
+    public:
+        enum { block_steps = 4096 };
+
+        FORCEINLINE blocked_sum() : _total(0.0), _steps(0) {}
+
+        template<int K>
+        FORCEINLINE void add(const vector<E, T, K>& v, const vector<E, T, K>& mask)
+        {
+            _block.add(v, mask);
+            if (++_steps == block_steps) flush();
+        }
+
+        double value() const { return _total + _block.value(); }
+
+    private:
+        void flush()
+        {
+            _total += _block.value();
+            _block = reduction<E, T, sum_op>();
+            _steps = 0;
+        }
+
+        reduction<E, T, sum_op> _block;
+        double _total;
+        int _steps;
+    };
+
+    // Counts mask lanes. A block adds at most block_steps * K ones per float lane, well
+    // below 2^24, and the double total is exact up to 2^53.
+    template<typename E, typename T = float>
+    class counter
+    {
+    public:
+        FORCEINLINE counter() : _one(T(1)) {}
+
+        template<int K>
+        FORCEINLINE void add(const vector<E, T, K>& mask)
+        {
+            vector<E, T, K> ones;
+            for (int i = 0; i < K; i++) ones.assign(i, _one.value());
+            _count.add(ones, mask);
+        }
+
+        size_t value() const { return (size_t)_count.value(); }
+
+    private:
+        blocked_sum<E, T> _count;
+        broadcast<E, T> _one;
+    };
+
+    // Horizontally reduced statistics of a point cloud, mergeable across threads
+    struct cloud_statistics
+    {
+        float min[3];
+        float max[3];
+        double sum[3];
+        size_t count;
+
+        cloud_statistics() : count(0)
+        {
+            for (int i = 0; i < 3; i++)
+            {
+                min[i] = min_op::identity<float>();
+                max[i] = max_op::identity<float>();
+                sum[i] = 0.0;
+            }
+        }
+
+        void merge(const cloud_statistics& other)
+        {
+            for (int i = 0; i < 3; i++)
+            {
+                min[i] = min_op::apply_scalar(min[i], other.min[i]);
+                max[i] = max_op::apply_scalar(max[i], other.max[i]);
+                sum[i] += other.sum[i];
+            }
+            count += other.count;
+        }
+
+        float centroid(int axis) const { return count ? (float)(sum[axis] / count) : 0.f; }
+    };
+
+    // Bounding box, centroid and valid-point count of gathered x / y / z
+    template<typename E, typename T = float>
+    class statistics_accumulator
+    {
+    public:
+        template<int K>
+        FORCEINLINE void add(const vector<E, T, K>& x, const vector<E, T, K>& y, const vector<E, T, K>& z,
+                             const vector<E, T, K>& valid)
+        {
+            add_axis(0, x, valid);
+            add_axis(1, y, valid);
+            add_axis(2, z, valid);
+            _count.add(valid);
+        }
+
+        cloud_statistics result() const
+        {
+            cloud_statistics s;
+            for (int i = 0; i < 3; i++)
+            {
+                s.min[i] = _min[i].value();
+                s.max[i] = _max[i].value();
+                s.sum[i] = _sum[i].value();
+            }
+            s.count = _count.value();
+            return s;
+        }
+
+    private:
+        template<int K>
+        FORCEINLINE void add_axis(int axis, const vector<E, T, K>& v, const vector<E, T, K>& valid)
+        {
+            _min[axis].add(v, valid);
+            _max[axis].add(v, valid);
+            _sum[axis].add(v, valid);
+        }
+
+        reduction<E, T, min_op> _min[3];
+        reduction<E, T, max_op> _max[3];
+        blocked_sum<E, T> _sum[3];
+        counter<E, T> _count;
+    };
+}
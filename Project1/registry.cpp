@@ -0,0 +1,82 @@
+#include "simd_registry.h"
+
+#include "core.h"
+#include "cpu_features.h"
+#include "registry_kernels.h"
+
+// Built for the baseline CPU and kept free of engine code, so loading the registry and
+// picking an engine run anywhere. Kernels come from the engine files, see registry_kernels.h.
+namespace
+{
+    using namespace simd;
+    using namespace simd::registry_detail;
+
+    static_assert((int)SIMD_ENGINE_DEFAULT == (int)DEFAULT && (int)SIMD_ENGINE_NAIVE == (int)NAIVE &&
+                  (int)SIMD_ENGINE_SUPERSPEED == (int)SUPERSPEED, "C engine ids must match engine_type!");
+
+    struct registry
+    {
+        kernel_table tables[SIMD_ENGINE_COUNT]; // All null for engines the CPU cannot run
+        simd_engine best;
+
+        // Engines are ranked by width, widest supported one wins
+        registry() : tables()
+        {
+            naive_kernels(tables[SIMD_ENGINE_NAIVE]);
+            best = SIMD_ENGINE_NAIVE;
+            if (has_ssse3())
+            {
+                sse_kernels(tables[SIMD_ENGINE_DEFAULT]);
+                best = SIMD_ENGINE_DEFAULT;
+            }
+            if (has_avx())
+            {
+                avx_kernels(tables[SIMD_ENGINE_SUPERSPEED]);
+                best = SIMD_ENGINE_SUPERSPEED;
+            }
+        }
+
+        static const registry& instance()
+        {
+            static const registry result;
+            return result;
+        }
+    };
+
+    // Filled in while the program loads, the first lookup from a hot path pays nothing
+    const registry& startup_registry = registry::instance();
+}
+
+extern "C" simd_kernel simd_find_kernel(simd_operation op, simd_layout input, simd_layout output, simd_engine engine)
+{
+    const auto& r = startup_registry;
+    if (engine == SIMD_ENGINE_BEST) engine = r.best;
+    if ((unsigned)op >= SIMD_OP_COUNT || (unsigned)input >= SIMD_LAYOUT_COUNT ||
+        (unsigned)output >= SIMD_LAYOUT_COUNT || (unsigned)engine >= SIMD_ENGINE_COUNT)
+        return nullptr;
+    return r.tables[engine].kernels[op][input][output];
+}
+
+extern "C" simd_engine simd_best_engine(void)
+{
+    return registry::instance().best;
+}
+
+extern "C" size_t simd_block_size(simd_engine engine)
+{
+    if (engine == SIMD_ENGINE_BEST) engine = simd_best_engine();
+    if ((unsigned)engine >= SIMD_ENGINE_COUNT) return 0;
+    return registry::instance().tables[engine].block_size;
+}
+
+extern "C" const char* simd_engine_name(simd_engine engine)
+{
+    if (engine == SIMD_ENGINE_BEST) engine = simd_best_engine();
+    switch (engine)
+    {
+    case SIMD_ENGINE_NAIVE: return "naive";
+    case SIMD_ENGINE_DEFAULT: return "sse";
+    case SIMD_ENGINE_SUPERSPEED: return "avx2";
+    default: return "unknown";
+    }
+}
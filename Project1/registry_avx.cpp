@@ -0,0 +1,7 @@
+// Built with -mavx2 -mfma -mf16c, only called once the CPU is known to have them
+#include "registry_engine.h"
+
+void simd::registry_detail::avx_kernels(kernel_table& table)
+{
+    add_kernels<SUPERSPEED>(table);
+}
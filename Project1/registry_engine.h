@@ -0,0 +1,130 @@
+#pragma once
+
+#include "registry_kernels.h"
+
+// Library headers of the engine code, at file scope, their include guards keep them
+// out of the namespace below
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+#include <tmmintrin.h>
+#ifndef SIMD_NO_AVX
+#include <immintrin.h>
+#ifdef _WIN32
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+// The engine headers themselves go inside an unnamed namespace, so every engine function
+// a registry file instantiates has internal linkage. Inline functions are otherwise merged
+// across the program, and the linker may keep a copy built with another file's
+// instruction set (i.e. AVX code from the demo in the SSE kernels).
+namespace
+{
+    namespace isa
+    {
+#include "simd.h"
+#include "rigid_transform.h"
+#include "projection.h"
+    }
+
+    using namespace isa::simd;
+    using simd::registry_detail::kernel_table;
+
+    struct float2 { float x; float y; };
+    struct float3 { float x; float y; float z; };
+
+    template<class TR>
+    struct rigid_transform_op
+    {
+        static void run(const simd_parameters& p, TR& t)
+        {
+            const rigid_transform_kernel<typename TR::engine_t> kernel(rigid_transform(p.rotation, p.translation));
+            for (auto i : t)
+            {
+                auto soa = i.gather(i.load());
+                typename TR::gather_type x, y, z;
+                kernel.apply(soa[0], soa[1], soa[2], x, y, z);
+                i.store(i.scatter(x, y, z));
+            }
+        }
+    };
+
+    template<class TR>
+    struct project_op
+    {
+        static void run(const simd_parameters& p, TR& t)
+        {
+            const projection_kernel<typename TR::engine_t> kernel(rigid_transform(p.rotation, p.translation),
+                pinhole{ p.width, p.height, p.ppx, p.ppy, p.fx, p.fy });
+            for (auto i : t)
+            {
+                auto soa = i.gather(i.load());
+                typename TR::gather_type u, v;
+                kernel.apply(soa[0], soa[1], soa[2], u, v);
+                i.store(i.scatter(u, v));
+            }
+        }
+    };
+
+    template<class D, simd_layout L> struct layout_of { typedef D type; };
+    template<class D> struct layout_of<D, SIMD_LAYOUT_SOA> { typedef soa<D> type; };
+
+    template<simd_operation OP> struct operation_of;
+    template<> struct operation_of<SIMD_OP_RIGID_TRANSFORM>
+    {
+        typedef float3 output_element;
+        template<class TR> struct op : rigid_transform_op<TR> {};
+    };
+    template<> struct operation_of<SIMD_OP_PROJECT>
+    {
+        typedef float2 output_element;
+        template<class TR> struct op : project_op<TR> {};
+    };
+
+    // The C-callable entry point of one (operation, layouts, engine) combination
+    template<simd_operation OP, simd_layout IN, simd_layout OUT, engine_type ET>
+    struct entry
+    {
+        typedef transformation<float, typename layout_of<float3, IN>::type,
+                               float, typename layout_of<typename operation_of<OP>::output_element, OUT>::type,
+                               ET> transformation_type;
+
+        static simd_status call(const simd_parameters* params, const float* input, float* output, size_t count)
+        {
+            if (!params || !input || !output) return SIMD_ERROR_INVALID_ARGUMENT;
+            if (count % transformation_type::blocks_gather) return SIMD_ERROR_INVALID_COUNT;
+
+            transformation_type t(const_cast<float*>(input), output, count);
+            operation_of<OP>::template op<transformation_type>::run(*params, t);
+            return SIMD_OK;
+        }
+    };
+
+    template<simd_operation OP, engine_type ET>
+    void add_layouts(kernel_table& table)
+    {
+        table.kernels[OP][SIMD_LAYOUT_AOS][SIMD_LAYOUT_AOS] = &entry<OP, SIMD_LAYOUT_AOS, SIMD_LAYOUT_AOS, ET>::call;
+        table.kernels[OP][SIMD_LAYOUT_AOS][SIMD_LAYOUT_SOA] = &entry<OP, SIMD_LAYOUT_AOS, SIMD_LAYOUT_SOA, ET>::call;
+        table.kernels[OP][SIMD_LAYOUT_SOA][SIMD_LAYOUT_AOS] = &entry<OP, SIMD_LAYOUT_SOA, SIMD_LAYOUT_AOS, ET>::call;
+        table.kernels[OP][SIMD_LAYOUT_SOA][SIMD_LAYOUT_SOA] = &entry<OP, SIMD_LAYOUT_SOA, SIMD_LAYOUT_SOA, ET>::call;
+    }
+
+    // No engine detection in here, the caller has already checked the CPU
+    template<engine_type ET>
+    void add_kernels(kernel_table& table)
+    {
+        add_layouts<SIMD_OP_RIGID_TRANSFORM, ET>(table);
+        add_layouts<SIMD_OP_PROJECT, ET>(table);
+        table.block_size = transformation<float, float3, float, float3, ET>::blocks_gather;
+    }
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "simd_registry.h"
+
+// Kernels of one engine, filled in by that engine's own translation unit
+// (registry_naive.cpp, registry_sse.cpp, registry_avx.cpp), each built with the
+// engine's instruction set. registry.cpp is built for the baseline CPU and asks for a
+// table only once the CPU is known to run the engine.
+namespace simd
+{
+    namespace registry_detail
+    {
+        struct kernel_table
+        {
+            simd_kernel kernels[SIMD_OP_COUNT][SIMD_LAYOUT_COUNT][SIMD_LAYOUT_COUNT];
+            size_t block_size;
+        };
+
+        void naive_kernels(kernel_table& table);
+        void sse_kernels(kernel_table& table);
+        void avx_kernels(kernel_table& table);
+    }
+}
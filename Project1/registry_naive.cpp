@@ -0,0 +1,8 @@
+// Built for the baseline CPU
+#define SIMD_NO_AVX
+#include "registry_engine.h"
+
+void simd::registry_detail::naive_kernels(kernel_table& table)
+{
+    add_kernels<NAIVE>(table);
+}
@@ -0,0 +1,8 @@
+// Built with -mssse3, only called once the CPU is known to have it
+#define SIMD_NO_AVX
+#include "registry_engine.h"
+
+void simd::registry_detail::sse_kernels(kernel_table& table)
+{
+    add_kernels<DEFAULT>(table);
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "core.h"
+#include "simd.h"
+
+namespace simd
+{
+    // 3x4 rigid transform, p' = R * p + t
+    class rigid_transform
+    {
+    public:
+        rigid_transform()
+        {
+            for (int r = 0; r < 3; r++)
+            {
+                for (int c = 0; c < 3; c++)
+                    _rotation[r][c] = (r == c) ? 1.f : 0.f;
+                _translation[r] = 0.f;
+            }
+        }
+
+        // Rotation is column-major, same as rs2_extrinsics
+        rigid_transform(const float rotation[9], const float translation[3])
+        {
+            for (int r = 0; r < 3; r++)
+            {
+                for (int c = 0; c < 3; c++)
+                    _rotation[r][c] = rotation[c * 3 + r];
+                _translation[r] = translation[r];
+            }
+        }
+
+        // Fold two transforms into one matrix at setup time:
+        // a.then(b) applies a first and b second, i.e. depth->imu then imu->world
+        rigid_transform then(const rigid_transform& next) const
+        {
+            rigid_transform result;
+            for (int r = 0; r < 3; r++)
+            {
+                for (int c = 0; c < 3; c++)
+                {
+                    result._rotation[r][c] = 0.f;
+                    for (int k = 0; k < 3; k++)
+                        result._rotation[r][c] += next._rotation[r][k] * _rotation[k][c];
+                }
+
+                result._translation[r] = next._translation[r];
+                for (int k = 0; k < 3; k++)
+                    result._translation[r] += next._rotation[r][k] * _translation[k];
+            }
+            return result;
+        }
+
+        float rotation(int row, int col) const { return _rotation[row][col]; }
+        float translation(int row) const { return _translation[row]; }
+
+    private:
+        float _rotation[3][3];
+        float _translation[3];
+    };
+
+    // Rigid transform with every coefficient already broadcast into engine registers,
+    // applied to SoA x / y / z as chains of multiply-adds
+    template<typename E, typename T = float>
+    class rigid_transform_kernel
+    {
+    public:
+        typedef broadcast<E, T> broadcast_t;
+
+        rigid_transform_kernel() : rigid_transform_kernel(rigid_transform()) {}
+        explicit rigid_transform_kernel(const rigid_transform& t)
+        {
+            for (int r = 0; r < 3; r++)
+            {
+                for (int c = 0; c < 3; c++)
+                    _rotation[r][c] = broadcast_t(t.rotation(r, c));
+                _translation[r] = broadcast_t(t.translation(r));
+            }
+        }
+
+        template<int K>
+        FORCEINLINE void apply(const vector<E, T, K>& x, const vector<E, T, K>& y, const vector<E, T, K>& z,
+                               vector<E, T, K>& out_x, vector<E, T, K>& out_y, vector<E, T, K>& out_z) const
+        {
+            out_x = row<0>(x, y, z);
+            out_y = row<1>(x, y, z);
+            out_z = row<2>(x, y, z);
+        }
+
+    private:
+        template<int R, int K>
+        FORCEINLINE vector<E, T, K> row(const vector<E, T, K>& x, const vector<E, T, K>& y, const vector<E, T, K>& z) const
+        {
+            return x.multiply_add(_rotation[R][0],
+                   y.multiply_add(_rotation[R][1],
+                   z.multiply_add(_rotation[R][2], _translation[R])));
+        }
+
+        broadcast_t _rotation[3][3];
+        broadcast_t _translation[3];
+    };
+}
@@ -4,14 +4,54 @@
 #include <type_traits>
 #include <tmmintrin.h>
 #include <array>
+#include <iostream>
+#include <typeinfo>
 
 #include "core.h"
+#include "layout.h"
 #include "sse.h"
 #include "naive.h"
+// Translation units built for CPUs without AVX leave that engine out (see registry_sse.cpp)
+#ifndef SIMD_NO_AVX
 #include "avx.h"
+#endif
 
 namespace simd
 {
+    // Scalar broadcast into an engine register once, up front,
+    // instead of on every operator call inside the loop
+    template<typename E, typename T>
+    class broadcast
+    {
+    public:
+        typedef typename E::template native_simd<T> vectorized_wrapper;
+        typedef typename E::template native_simd<T>::representation_type simd_t;
+
+        FORCEINLINE broadcast() : _value() {}
+        FORCEINLINE explicit broadcast(T value) : _value(vectorized_wrapper::vectorize(value)) {}
+
+        FORCEINLINE const simd_t& value() const { return _value; }
+
+    private:
+        simd_t _value;
+    };
+
+    // Per-lane access to a single engine register
+    template<typename E, typename T>
+    struct lanes
+    {
+        typedef typename E::template native_simd<T> vectorized_wrapper;
+        typedef typename E::template native_simd<T>::representation_type simd_t;
+        typedef typename E::template native_simd<T>::underlying_type underlying_t;
+
+        enum { count = sizeof(underlying_t) / sizeof(T) };
+
+        FORCEINLINE static void extract(const simd_t& v, T* out)
+        {
+            vectorized_wrapper::store(v, reinterpret_cast<underlying_t*>(out));
+        }
+    };
+
     template<typename E, typename T, int K>
     class vector
     {
@@ -20,6 +60,7 @@ namespace simd
         typedef typename E::template native_simd<T>::representation_type simd_t;
         typedef typename E::template native_simd<T>::underlying_type underlying_t;
         typedef vector<E, T, K> this_class;
+        typedef broadcast<E, T> broadcast_t;
         enum { blocks = K };
 
         FORCEINLINE vector() : _data() {}
@@ -56,12 +97,12 @@ namespace simd
                 _data[i] = f(from._data[i], to._data[i]);
         }
 
-        FORCEINLINE this_class operator-(float y)
+        FORCEINLINE this_class operator-(T y)
         {
             simd_t vec_y = vectorized_wrapper::vectorize(y);
             return{ *this, [&](simd_t& item) { return item - vec_y; } };
         }
-        FORCEINLINE this_class operator+(float y)
+        FORCEINLINE this_class operator+(T y)
         {
             simd_t vec_y = vectorized_wrapper::vectorize(y);
             return{ *this, [&](simd_t& item) { return item + vec_y; } };
@@ -74,21 +115,119 @@ namespace simd
         {
             return{ *this, y, [&](simd_t& a,  const simd_t& b) { return a - b; } };
         }
-        FORCEINLINE this_class operator*(float y)
+        FORCEINLINE this_class operator*(T y)
         {
             simd_t vec_y = vectorized_wrapper::vectorize(y);
             return{ *this, [&](simd_t& item) { return item * vec_y; } };
         }
+        FORCEINLINE this_class operator*(const this_class& y)
+        {
+            return{ *this, y, [&](simd_t& a, const simd_t& b) { return a * b; } };
+        }
         FORCEINLINE this_class operator/(const this_class& y)
         {
             return{ *this, y, [&](simd_t& a, const simd_t& b) { return a / b; } };
         }
-        FORCEINLINE this_class operator/(float y)
+        FORCEINLINE this_class operator/(T y)
         {
             simd_t vec_y = vectorized_wrapper::vectorize(y);
             return{ *this, [&](simd_t& item) { return item / vec_y; } };
         }
 
+        FORCEINLINE this_class operator*(const broadcast_t& y) const
+        {
+            this_class result;
+            for (int i = 0; i < K; i++)
+                result._data[i] = _data[i] * y.value();
+            return result;
+        }
+        FORCEINLINE this_class operator+(const broadcast_t& y) const
+        {
+            this_class result;
+            for (int i = 0; i < K; i++)
+                result._data[i] = _data[i] + y.value();
+            return result;
+        }
+
+        FORCEINLINE static this_class min(const this_class& a, const this_class& b)
+        {
+            this_class result;
+            for (int i = 0; i < K; i++)
+                result._data[i] = vectorized_wrapper::min(a._data[i], b._data[i]);
+            return result;
+        }
+        FORCEINLINE static this_class max(const this_class& a, const this_class& b)
+        {
+            this_class result;
+            for (int i = 0; i < K; i++)
+                result._data[i] = vectorized_wrapper::max(a._data[i], b._data[i]);
+            return result;
+        }
+        FORCEINLINE static this_class sqrt(const this_class& a)
+        {
+            this_class result;
+            for (int i = 0; i < K; i++)
+                result._data[i] = vectorized_wrapper::sqrt(a._data[i]);
+            return result;
+        }
+
+        // Lane masks for select(), see the engine for their representation
+        FORCEINLINE this_class greater(const broadcast_t& y) const
+        {
+            this_class result;
+            for (int i = 0; i < K; i++)
+                result._data[i] = vectorized_wrapper::greater(_data[i], y.value());
+            return result;
+        }
+        FORCEINLINE this_class less(const broadcast_t& y) const
+        {
+            this_class result;
+            for (int i = 0; i < K; i++)
+                result._data[i] = vectorized_wrapper::less(_data[i], y.value());
+            return result;
+        }
+        FORCEINLINE static this_class select(const this_class& mask, const this_class& a, const this_class& b)
+        {
+            this_class result;
+            for (int i = 0; i < K; i++)
+                result._data[i] = vectorized_wrapper::select(mask._data[i], a._data[i], b._data[i]);
+            return result;
+        }
+
+        // One bit per lane of a mask, register 0 in the lowest bits, and back
+        enum { lanes_per_register = sizeof(underlying_t) / sizeof(T) };
+        FORCEINLINE unsigned int bits() const
+        {
+            static_assert(K * lanes_per_register <= 32, "Mask does not fit 32 bits!");
+            unsigned int result = 0;
+            for (int i = 0; i < K; i++)
+                result |= (unsigned int)vectorized_wrapper::movemask(_data[i]) << (i * lanes_per_register);
+            return result;
+        }
+        FORCEINLINE static this_class from_bits(unsigned int bits)
+        {
+            this_class result;
+            for (int i = 0; i < K; i++)
+                result._data[i] = vectorized_wrapper::mask_from_bits((int)(bits >> (i * lanes_per_register)));
+            return result;
+        }
+
+        // this * y + z, fused on engines that have FMA
+        FORCEINLINE this_class multiply_add(const broadcast_t& y, const this_class& z) const
+        {
+            this_class result;
+            for (int i = 0; i < K; i++)
+                result._data[i] = vectorized_wrapper::fmadd(_data[i], y.value(), z._data[i]);
+            return result;
+        }
+        FORCEINLINE this_class multiply_add(const broadcast_t& y, const broadcast_t& z) const
+        {
+            this_class result;
+            for (int i = 0; i < K; i++)
+                result._data[i] = vectorized_wrapper::fmadd(_data[i], y.value(), z.value());
+            return result;
+        }
+
     private:
         simd_t _data[K];
     };
@@ -106,17 +245,29 @@ namespace simd
         enum { value = (A * B) / GCD<A, B>::value };
     };
 
-    template<typename T1, class D1, typename T2, class D2, engine_type ET = DEFAULT>
+    // U is the register-blocking factor: every iterator step covers U registers' worth
+    // of elements, so each gathered variable is U registers wide
+    template<typename T1, class D1, typename T2, class D2, engine_type ET = DEFAULT, int U = 1>
     class transformation
     {
     public:
+        typedef engine<ET> engine_t;
+        typedef T1 input_scalar;
+        typedef T2 output_scalar;
         typedef typename engine<ET>::template native_simd<T1>::underlying_type input_underlying_type;
         typedef typename engine<ET>::template native_simd<T2>::underlying_type output_underlying_type;
 
-        enum { elements_in = sizeof(D1) / sizeof(T1) };
-        enum { elements_out = sizeof(D2) / sizeof(T2) };
+        typedef layout_traits<D1> input_layout;
+        typedef layout_traits<D2> output_layout;
+        typedef typename input_layout::element_type input_element;
+        typedef typename output_layout::element_type output_element;
 
-        enum { blocks_gather  = sizeof(input_underlying_type) / sizeof(T1) };
+        enum { elements_in = sizeof(input_element) / sizeof(T1) };
+        enum { elements_out = sizeof(output_element) / sizeof(T2) };
+
+        enum { unroll = U };
+        enum { lanes_gather   = sizeof(input_underlying_type) / sizeof(T1) };
+        enum { blocks_gather  = lanes_gather * U };
         enum { blocks_in      = blocks_gather * elements_in };
         enum { blocks_out     = blocks_gather * elements_out * sizeof(T1) / sizeof(T2) };
 
@@ -129,13 +280,144 @@ namespace simd
         typedef vector<engine<ET>, T2, width_out / elements_out> scatter_type;
         typedef vector<engine<ET>, T2, width_out> output_type;
 
-        transformation(T1 * input, T2 * output, int count) : _count(count)
+        static_assert(U >= 1, "Register blocking factor must be positive!");
+        static_assert(input_layout::group % lanes_gather == 0 || input_layout::group == 1,
+            "AoSoA group must hold a whole number of SIMD registers!");
+        static_assert(output_layout::group % lanes_gather == 0 || output_layout::group == 1,
+            "AoSoA group must hold a whole number of SIMD registers!");
+
+        static_assert((int)output_layout::access != (int)STRIDED, "Strided layouts are input only!");
+
+        // Registers a step keeps live, gathered inputs plus scattered outputs. Broadcast
+        // constants are left out, the compiler can keep them as memory operands.
+        enum { live_registers = (elements_in + elements_out) * U };
+        static bool may_spill() { return (int)live_registers > (int)engine<ET>::registers; }
+
+        // Layout pairs where block i, written over its own input, only lands on scalars
+        // of blocks up to i: interleaved output over interleaved / strided records, or
+        // planes over planes of the same grouping
+        enum { layouts_alias = ((int)output_layout::access == (int)INTERLEAVED && (int)input_layout::access != (int)PLANAR) ||
+                               (output_layout::planar && (int)input_layout::access == (int)PLANAR &&
+                                (int)input_layout::group == (int)output_layout::group &&
+                                (input_layout::group == 1 || (int)elements_in == (int)elements_out)) };
+
+        transformation() : _src(nullptr), _dst(nullptr), _count(0), _first(0), _blocks(0),
+            _input_stride(default_stride() / sizeof(T1)), _input_offset(default_offset() / sizeof(T1)) {}
+        transformation(T1 * input, T2 * output, size_t count) : transformation() { bind(input, output, count); }
+        transformation(span<T1> input, span<T2> output) : transformation() { bind(input, output); }
+        transformation(T1 * buffer, size_t count) : transformation() { bind(buffer, count); }
+
+        // Re-target the transformation at new buffers (i.e. the next frame)
+        // without paying for construction or engine selection again. A runtime
+        // input stride is kept, every frame of a stream has the same records.
+        void bind(T1 * input, T2 * output, size_t count)
+        {
+            assert((count * sizeof(input_element)) % (width_in * sizeof(input_underlying_type)) == 0);
+            assert((count * sizeof(output_element)) % (width_out * sizeof(output_underlying_type)) == 0);
+            assert(count % input_layout::group == 0 && count % output_layout::group == 0);
+
+            _src = input;
+            _dst = output;
+            _count = count;
+            _first = 0;
+            _blocks = count / blocks_gather;
+            assert(!in_place() || can_alias());
+        }
+        // Strided records are counted by the layout's stride. The last one may be cut short,
+        // but not before the end of what the gather reads, see record_reads(). A runtime
+        // stride is not known yet, so it needs a count.
+        void bind(span<T1> input, span<T2> output)
+        {
+            static_assert(!stride_of<input_layout>::runtime, "Runtime-stride input must be bound with an explicit count!");
+            const size_t bytes = input.size() * sizeof(T1);
+            const size_t used = default_offset() + record_reads();
+            const auto count = bytes >= used ? (bytes - used) / default_stride() + 1 : 0;
+            assert(output.size() >= count * elements_out);
+            bind(input.data(), output.data(), count);
+        }
+        // In place, results overwrite the input (i.e. float3 -> float3 re-framing)
+        void bind(T1 * buffer, size_t count)
         {
-            assert((count * sizeof(D1)) % (width_in * sizeof(input_underlying_type)) == 0);
-            assert((count * sizeof(D2)) % (width_out * sizeof(output_underlying_type)) == 0);
+            static_assert(std::is_same<T1, T2>::value, "In place needs the same scalar type on both sides!");
+            bind(buffer, reinterpret_cast<T2*>(buffer), count);
+        }
 
-            _src = reinterpret_cast<const input_underlying_type*>(input);
-            _dst = reinterpret_cast<output_underlying_type*>(output);
+        // Record stride and field offset, in bytes, of a runtime strided<D> input,
+        // kept until set again
+        void set_input_stride(size_t stride, size_t offset)
+        {
+            assert(stride % sizeof(T1) == 0 && offset % sizeof(T1) == 0);
+            assert(stride >= offset + sizeof(input_element));
+            _input_stride = stride / sizeof(T1);
+            _input_offset = offset / sizeof(T1);
+            assert(!in_place() || can_alias());
+        }
+        size_t input_stride() const { return _input_stride * sizeof(T1); }
+
+        // Input and output are the same buffer. Only exact aliasing is supported, and only
+        // when output elements are no wider than input records. Blocks are visited in order
+        // and each is loaded whole before it is stored, so no input is overwritten unread.
+        bool in_place() const { return _src && (const void*)_src == (const void*)_dst; }
+        bool can_alias() const { return layouts_alias && sizeof(output_element) <= _input_stride * sizeof(T1); }
+
+        // Slices may run concurrently, unless in place with a narrower output, where a
+        // slice would overwrite input of the slice before it
+        bool can_split() const { return !in_place() || sizeof(output_element) == _input_stride * sizeof(T1); }
+
+        // Number of D1 elements and number of iterator steps
+        size_t size() const { return _blocks * blocks_gather; }
+        size_t blocks() const { return _blocks; }
+        size_t first_block() const { return _first; }
+
+        // Sub-range of whole blocks that shares this transformation's geometry,
+        // i.e. to hand a part of the frame to a worker thread
+        transformation slice(size_t first_block, size_t count) const
+        {
+            assert(first_block + count <= blocks());
+            // Buffers stay bound as a whole, planar layouts need the full plane size
+            transformation result(*this);
+            result._first = _first + first_block;
+            result._blocks = count;
+            return result;
+        }
+
+        // Output scalars written by the blocks of this object, contiguous for interleaved
+        // outputs only, i.e. to stream a finished slice out as raw records
+        span<T2> output_blocks() const
+        {
+            static_assert(!output_layout::planar, "Planar outputs spread a block over every plane!");
+            return span<T2>(_dst + _first * blocks_out, _blocks * blocks_out);
+        }
+
+    private:
+        template<class L, int ACCESS = L::access>
+        struct stride_of
+        {
+            enum { stride = sizeof(input_element), offset = 0, runtime = 0 };
+        };
+        template<class L>
+        struct stride_of<L, STRIDED>
+        {
+            enum { stride = (int)L::stride != 0 ? L::stride : sizeof(input_element), offset = L::offset, runtime = L::stride == 0 };
+        };
+
+    public:
+        static size_t default_stride() { return stride_of<input_layout>::stride; }
+        static size_t default_offset() { return stride_of<input_layout>::offset; }
+
+        // Bytes of an input record read from the element on: 4 scalars where fixed strides
+        // leave room to transpose whole records (see load_block), otherwise the element
+        static size_t record_reads()
+        {
+            return (int)input_layout::access == (int)STRIDED && !stride_of<input_layout>::runtime && elements_in <= 4 &&
+                   default_stride() >= default_offset() + 4 * sizeof(T1) ? 4 * sizeof(T1) : sizeof(input_element);
+        }
+
+        // Engine detection runs once per engine, not once per frame
+        static bool supported()
+        {
+            static const bool result = engine<ET>::can_run();
+            return result;
         }
 
         template<class S>
@@ -146,7 +428,7 @@ namespace simd
               << sizeof(input_underlying_type) * width_in << " bytes\t"
               << sizeof(input_underlying_type) * width_in / sizeof(T1) << " x "
               << typeid(T1).name() << "\t"
-              << sizeof(input_underlying_type) * width_in / sizeof(D1) << " x "
+              << sizeof(input_underlying_type) * width_in / sizeof(input_element) << " x "
               << typeid(D1).name() << "\t"
               << "\n";
             s << "Gather Type:\t" << width_gather
@@ -160,15 +442,19 @@ namespace simd
               << sizeof(output_underlying_type) * width_out << " bytes\t"
               << sizeof(output_underlying_type) * width_out / sizeof(T2) << " x "
               << typeid(T2).name() << "\t"
-              << sizeof(output_underlying_type) * width_out / sizeof(D2) << " x "
+              << sizeof(output_underlying_type) * width_out / sizeof(output_element) << " x "
               << typeid(D2).name() << "\t"
               << "\n";
+            s << "Blocking:\t" << U << " x\t" << live_registers << " of "
+              << engine<ET>::registers << " registers live\n";
+            if (may_spill())
+                s << "Warning: blocking factor " << U << " needs more registers than the engine has, expect spills\n";
         }
         
         template<class T>
         void apply(T action)
         {
-            if (engine<ET>::can_run())
+            if (supported())
             {
                 action(*this);
             }
@@ -181,7 +467,7 @@ namespace simd
         class iterator
         {
         public:
-            typedef transformation<T1, D1, T2, D2> this_class;
+            typedef transformation<T1, D1, T2, D2, ET, U> this_class;
 
             FORCEINLINE iterator(transformation* owner, size_t index = 0) : _owner(owner), _index(index) {}
             FORCEINLINE iterator& operator++() { ++_index; return *this; }
@@ -193,13 +479,19 @@ namespace simd
             /// ========================= GATHER ===============================================
 
         private:
+            // One register's worth of elements, what the engine shuffles operate on
+            typedef vector<engine<ET>, T1, elements_in> sub_input_type;
+            typedef vector<engine<ET>, T1, 1> sub_gather_type;
+            typedef vector<engine<ET>, T2, elements_out> sub_output_type;
+            typedef vector<engine<ET>, T2, 1> sub_scatter_type;
+
             template<unsigned int INDEX, typename Dummy = int>
             struct gather_loop
             {
-                static void gather(const input_type& block, std::array<gather_type, elements_in>& results)
+                static void gather(const sub_input_type& block, std::array<sub_gather_type, elements_in>& results)
                 {
                     engine<ET>::template gather_utils<T1, INDEX - 1, elements_in>
-                        ::template gather<gather_type, input_type>(block, results[INDEX - 1]);
+                        ::template gather<sub_gather_type, sub_input_type>(block, results[INDEX - 1]);
 
                     gather_loop<INDEX - 1>::gather(block, results);
                 }
@@ -207,56 +499,96 @@ namespace simd
             template<typename Dummy>
             struct gather_loop<0, Dummy>
             {
-                FORCEINLINE static void gather(const input_type& block, std::array<gather_type, elements_in>& results) {}
+                FORCEINLINE static void gather(const sub_input_type& block, std::array<sub_gather_type, elements_in>& results) {}
             };
 
+            // Interleaved input, U sub-blocks one after the other, each gathered on its own
+            // into register u of every variable
+            FORCEINLINE static void gather_block(const input_type& block, std::array<gather_type, elements_in>& results, std::false_type)
+            {
+                for (int u = 0; u < U; u++)
+                {
+                    sub_input_type sub;
+                    for (int i = 0; i < elements_in; i++)
+                        sub.assign(i, block.fetch(u * elements_in + i));
+
+                    std::array<sub_gather_type, elements_in> parts;
+                    gather_loop<elements_in>::gather(sub, parts);
+                    for (int i = 0; i < elements_in; i++)
+                        results[i].assign(u, parts[i].fetch(0));
+                }
+            }
+            // Planar input, every register of the block already holds one component
+            FORCEINLINE static void gather_block(const input_type& block, std::array<gather_type, elements_in>& results, std::true_type)
+            {
+                for (int i = 0; i < elements_in; i++)
+                    for (int u = 0; u < U; u++)
+                        results[i].assign(u, block.fetch(i * U + u));
+            }
+
         public:
-            std::array<gather_type, elements_in> gather(const input_type& block) const
+            FORCEINLINE std::array<gather_type, elements_in> gather(const input_type& block) const
             {
-                static_assert(input_type::blocks == elements_in, "No extra unrolling assumption!");
+                static_assert(input_type::blocks == elements_in * U, "Input block must hold U registers per component!");
 
                 std::array<gather_type, elements_in> result;
-                gather_loop<elements_in>::gather(block, result);
+                gather_block(block, result, std::integral_constant<bool, input_layout::planar>());
                 return result;
             }
 
             /// ========================= SCATTER ===============================================
         private:
             template<int INDEX>
-            static void perform_scatter(output_type& block, const scatter_type& result)
+            static void perform_scatter(sub_output_type& block, const sub_scatter_type& result, std::false_type)
             {
-                const auto idx = INDEX;
-                const auto start = elements_out - INDEX - 1;
                 engine<ET>::template scatter_utils<T2, elements_out - INDEX - 1, elements_out>
-                    ::template scatter<output_type, scatter_type>(block, result);
+                    ::template scatter<sub_output_type, sub_scatter_type>(block, result);
+            }
+            // Planar output, every variable becomes one register of the block as is
+            template<int INDEX>
+            static void perform_scatter(sub_output_type& block, const sub_scatter_type& result, std::true_type)
+            {
+                block.assign(elements_out - INDEX - 1, result.fetch(0));
             }
 
+            // Register u of every variable into one sub-block
             template<int INDEX, class T, class... A>
             struct scatter_helper
             {
-                static void scatter_internal(output_type& result, const T& t, const A&... args)
+                FORCEINLINE static void scatter_internal(sub_output_type& result, int u, const T& t, const A&... args)
                 {
-                    perform_scatter<INDEX>(result, t);
-                    scatter_helper<INDEX - 1, A...>::scatter_internal(result, args...);
+                    sub_scatter_type reg;
+                    reg.assign(0, t.fetch(u));
+                    perform_scatter<INDEX>(result, reg, std::integral_constant<bool, output_layout::planar>());
+                    scatter_helper<INDEX - 1, A...>::scatter_internal(result, u, args...);
                 }
             };
             template<class T>
             struct scatter_helper<0, T>
             {
-                static void scatter_internal(output_type& result, const T& t)
+                FORCEINLINE static void scatter_internal(sub_output_type& result, int u, const T& t)
                 {
-                    perform_scatter<0>(result, t);
+                    sub_scatter_type reg;
+                    reg.assign(0, t.fetch(u));
+                    perform_scatter<0>(result, reg, std::integral_constant<bool, output_layout::planar>());
                 }
             };
 
         public:
             template<class T, class... A>
-            output_type scatter(const T& t, const A&... args) const
+            FORCEINLINE output_type scatter(const T& t, const A&... args) const
             {
                 static_assert(sizeof...(args) == elements_out - 1, 
                     "Scatter must be called with exactly number of arguments in the output type!");
                 output_type result;
-                scatter_helper<elements_out - 1, T, A...>::scatter_internal(result, t, args...);
+                for (int u = 0; u < U; u++)
+                {
+                    sub_output_type sub;
+                    scatter_helper<elements_out - 1, T, A...>::scatter_internal(sub, u, t, args...);
+                    // Interleaved sub-blocks follow each other, planar keeps U registers per component
+                    for (int i = 0; i < elements_out; i++)
+                        result.assign(output_layout::planar ? i * U + u : u * elements_out + i, sub.fetch(i));
+                }
                 return result;
             }
 
@@ -264,29 +596,139 @@ namespace simd
 
             input_type load()
             {
-                return &_owner->_src[_index * width_in];
+                return load_block(std::integral_constant<int, input_layout::access>());
             }
 
             void store(const output_type& val)
             {
-                val.store(&_owner->_dst[_index * width_out]);
+                store_block(val, std::integral_constant<bool, output_layout::planar>());
+            }
+
+            // Same element positions as store(), into a buffer of 16-bit values encoded as F
+            template<class F>
+            void store(const output_type& val, uint16_t* target, F format)
+            {
+                static_assert(std::is_same<T2, float>::value, "Only float output can be stored encoded!");
+                typedef typename engine<ET>::template format_utils<F> utils;
+                for (int i = 0; i < width_out; i++)
+                    utils::encode(val.fetch(i), target + output_offset(i));
+            }
+
+            // load() from a buffer of 16-bit values encoded as F
+            template<class F>
+            input_type load(const uint16_t* source, F format)
+            {
+                static_assert(std::is_same<T1, float>::value, "Only float input can be loaded encoded!");
+                static_assert((int)input_layout::access != (int)STRIDED, "Strided input can not be loaded encoded!");
+                typedef typename engine<ET>::template format_utils<F> utils;
+                input_type result;
+                for (int i = 0; i < width_in; i++)
+                    result.assign(i, utils::decode(source + input_offset(i)));
+                return result;
             }
 
         private:
+            enum { lanes_in = sizeof(input_underlying_type) / sizeof(T1) };
+            enum { lanes_out = sizeof(output_underlying_type) / sizeof(T2) };
+
+            // Scalar position of register i of the block, as load() / store() address it
+            FORCEINLINE size_t input_offset(int i) const
+            {
+                return input_layout::planar
+                    ? input_layout::template offset<elements_in>(_index * blocks_gather + (i % U) * lanes_in, i / U, _owner->_count)
+                    : _index * blocks_in + i * lanes_in;
+            }
+            FORCEINLINE size_t output_offset(int i) const
+            {
+                return output_layout::planar
+                    ? output_layout::template offset<elements_out>(_index * blocks_gather + (i % U) * lanes_out, i / U, _owner->_count)
+                    : _index * blocks_out + i * lanes_out;
+            }
+
+            FORCEINLINE input_type load_block(std::integral_constant<int, INTERLEAVED>) const
+            {
+                return reinterpret_cast<const input_underlying_type*>(&_owner->_src[_index * blocks_in]);
+            }
+            // Planar input, one register per component straight from its plane
+            FORCEINLINE input_type load_block(std::integral_constant<int, PLANAR>) const
+            {
+                input_type result;
+                for (int i = 0; i < elements_in; i++)
+                {
+                    for (int u = 0; u < U; u++)
+                    {
+                        typename input_type::simd_t reg;
+                        const auto offset = input_layout::template offset<elements_in>(_index * blocks_gather + u * lanes_in, i, _owner->_count);
+                        input_type::vectorized_wrapper::load(reg, reinterpret_cast<const input_underlying_type*>(&_owner->_src[offset]));
+                        result.assign(i * U + u, reg);
+                    }
+                }
+                return result;
+            }
+
+            // Strided input, components picked from every record of the block. Fixed strides
+            // can read whole records and transpose them when 4 floats fit past the field start
+            FORCEINLINE input_type load_block(std::integral_constant<int, STRIDED>) const
+            {
+                enum { stride = input_layout::stride / sizeof(T1) };
+
+                input_type result;
+                for (int u = 0; u < U; u++)
+                {
+                    sub_input_type sub;
+                    const auto base = &_owner->_src[(_index * blocks_gather + u * lanes_in) * _owner->_input_stride + _owner->_input_offset];
+                    gather_records<stride>(base, sub, std::integral_constant<bool, stride != 0>());
+                    for (int i = 0; i < elements_in; i++)
+                        result.assign(i * U + u, sub.fetch(i));
+                }
+                return result;
+            }
+            // Stride in the type
+            template<int STRIDE>
+            FORCEINLINE void gather_records(const T1* base, sub_input_type& sub, std::true_type) const
+            {
+                enum { fits = elements_in <= 4 && STRIDE >= input_layout::offset / sizeof(T1) + 4 };
+                engine<ET>::template strided_utils<T1, elements_in>::template gather<STRIDE, fits>(base, sub);
+            }
+            // Stride 0 in the type, the one set at runtime
+            template<int STRIDE>
+            FORCEINLINE void gather_records(const T1* base, sub_input_type& sub, std::false_type) const
+            {
+                const bool fits = elements_in <= 4 && _owner->_input_stride >= _owner->_input_offset + 4;
+                engine<ET>::template strided_utils<T1, elements_in>::gather(base, _owner->_input_stride, fits, sub);
+            }
+
+            FORCEINLINE void store_block(const output_type& val, std::false_type)
+            {
+                val.store(reinterpret_cast<output_underlying_type*>(&_owner->_dst[_index * blocks_out]));
+            }
+            FORCEINLINE void store_block(const output_type& val, std::true_type)
+            {
+                for (int i = 0; i < elements_out; i++)
+                {
+                    for (int u = 0; u < U; u++)
+                    {
+                        const auto offset = output_layout::template offset<elements_out>(_index * blocks_gather + u * lanes_out, i, _owner->_count);
+                        output_type::vectorized_wrapper::store(val.fetch(i * U + u), reinterpret_cast<output_underlying_type*>(&_owner->_dst[offset]));
+                    }
+                }
+            }
+
             size_t _index = 0;
             transformation* _owner;
         };
 
-        FORCEINLINE iterator begin() { return iterator(this); }
-        FORCEINLINE iterator end()
-        {
-            return iterator(this, (_count * sizeof(T1)) / sizeof(input_underlying_type));
-        }
+        FORCEINLINE iterator begin() { return iterator(this, _first); }
+        FORCEINLINE iterator end() { return iterator(this, _first + _blocks); }
 
     private:
-        const input_underlying_type* _src;
-        output_underlying_type* _dst;
-        const int _count;
+        const T1* _src;
+        T2* _dst;
+        size_t _count;  // Elements in the bound buffers
+        size_t _first;  // Block range this object iterates over
+        size_t _blocks;
+        size_t _input_stride; // Scalars between consecutive input records
+        size_t _input_offset; // Scalars from the record start to the element
     };
 
 }
@@ -0,0 +1,71 @@
+#ifndef SIMD_REGISTRY_H
+#define SIMD_REGISTRY_H
+
+/* C interface to pre-instantiated kernels. Callers look a kernel up once by
+   operation, layouts and engine, and then call it through a plain function
+   pointer, without seeing any of the templates behind it. */
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum simd_operation
+{
+    SIMD_OP_RIGID_TRANSFORM, /* float3 -> float3, p' = R * p + t */
+    SIMD_OP_PROJECT,         /* float3 -> float2, extrinsics + pinhole into normalized (u, v) */
+    SIMD_OP_COUNT
+} simd_operation;
+
+typedef enum simd_layout
+{
+    SIMD_LAYOUT_AOS, /* x y z x y z ... */
+    SIMD_LAYOUT_SOA, /* x[count] y[count] z[count] */
+    SIMD_LAYOUT_COUNT
+} simd_layout;
+
+typedef enum simd_engine
+{
+    SIMD_ENGINE_DEFAULT,    /* SSE */
+    SIMD_ENGINE_NAIVE,      /* Scalar */
+    SIMD_ENGINE_SUPERSPEED, /* AVX2 + FMA */
+    SIMD_ENGINE_COUNT,
+    SIMD_ENGINE_BEST = -1   /* Fastest engine the running CPU supports */
+} simd_engine;
+
+typedef enum simd_status
+{
+    SIMD_OK = 0,
+    SIMD_ERROR_NOT_FOUND = -1,     /* No such kernel, or engine not supported by the CPU */
+    SIMD_ERROR_INVALID_COUNT = -2, /* count is not a whole number of SIMD blocks */
+    SIMD_ERROR_INVALID_ARGUMENT = -3
+} simd_status;
+
+typedef struct simd_parameters
+{
+    float rotation[9];    /* Column-major, same as rs2_extrinsics */
+    float translation[3];
+    float width, height, ppx, ppy, fx, fy; /* SIMD_OP_PROJECT only */
+} simd_parameters;
+
+typedef simd_status (*simd_kernel)(const simd_parameters* params, const float* input, float* output, size_t count);
+
+/* Kernel for the given key, or NULL. SIMD_ENGINE_BEST resolves to the fastest
+   supported engine, chosen once on first use. */
+simd_kernel simd_find_kernel(simd_operation op, simd_layout input, simd_layout output, simd_engine engine);
+
+/* Engine SIMD_ENGINE_BEST resolves to on this CPU */
+simd_engine simd_best_engine(void);
+
+/* count has to be a multiple of this for every kernel of engine, 0 if the CPU
+   cannot run the engine */
+size_t simd_block_size(simd_engine engine);
+
+const char* simd_engine_name(simd_engine engine);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <stdint.h>
+
+#include "core.h"
+#include "simd.h"
+
+namespace simd
+{
+    // Rectangle of an organized frame, in pixels
+    struct roi
+    {
+        size_t x;
+        size_t y;
+        size_t width;
+        size_t height;
+    };
+
+    // A rectangle of an organized frame, i.e. the bounding box of an object. Every row
+    // of the rectangle is a transformation of its own, bound to that row's pixels of the
+    // frame buffers, so results land where the whole-frame transformation would put them
+    // and nothing outside the rows is touched. Rows are widened to whole iterator steps,
+    // a few columns left or right of the rectangle may be processed as well. Any
+    // rectangle fits frames whose width is a multiple of the step.
+    template<typename T1, class D1, typename T2, class D2, engine_type ET = DEFAULT, int U = 1>
+    class roi_transformation
+    {
+    public:
+        typedef transformation<T1, D1, T2, D2, ET, U> row_type;
+        typedef typename row_type::engine_t engine_t;
+
+        enum { steps = row_type::blocks_gather };
+
+        static_assert((int)row_type::input_layout::access == (int)INTERLEAVED && (int)row_type::output_layout::access == (int)INTERLEAVED,
+            "Frame rows are cut out of interleaved buffers!");
+
+        roi_transformation(T1* input, T2* output, size_t frame_width, size_t frame_height, const roi& r)
+            : _input(input), _output(output), _frame_width(frame_width)
+        {
+            assert(r.x + r.width <= frame_width && r.y + r.height <= frame_height);
+
+            // Whole steps from the step boundary at or left of the rectangle, moved left
+            // if that runs past the frame
+            _first_row = r.y;
+            _rows = r.width ? r.height : 0;
+            _first_column = r.x - r.x % steps;
+            _columns = (r.x + r.width - _first_column + steps - 1) / steps * steps;
+            assert(_columns <= frame_width);
+            _first_column = std::min(_first_column, frame_width - _columns);
+        }
+
+        size_t rows() const { return _rows; }
+        size_t first_column() const { return _first_column; }
+        size_t columns() const { return _columns; }
+
+        // Row r of the rectangle
+        row_type row(size_t r) const
+        {
+            const size_t pixel = (_first_row + r) * _frame_width + _first_column;
+            return row_type(_input + pixel * row_type::elements_in, _output + pixel * row_type::elements_out, _columns);
+        }
+
+        static bool supported() { return row_type::supported(); }
+
+        template<class T>
+        void apply(T action)
+        {
+            if (!supported())
+            {
+                std::cout << "Engine not supported!" << std::endl;
+                return;
+            }
+            for (size_t r = 0; r < _rows; r++)
+            {
+                auto t = row(r);
+                action(t);
+            }
+        }
+
+    private:
+        T1* _input;
+        T2* _output;
+        size_t _frame_width;
+        size_t _first_row, _rows;
+        size_t _first_column, _columns;
+    };
+
+    // Records picked from an input buffer by a list of indices (i.e. tracked features),
+    // results written compactly, result i for record indices[i]. load() fetches the
+    // records of a register of indices straight into one register per component, with
+    // hardware gather where the engine has it, so gather() has nothing left to do and
+    // apps written for transformation run unchanged. The work is proportional to the
+    // number of indices, not to the size of the input. The last partial register runs
+    // on padded indices into a scratch block, and only its valid results are copied.
+    template<typename T1, class D1, typename T2, class D2, engine_type ET = DEFAULT>
+    class sparse_transformation
+    {
+    public:
+        typedef transformation<T1, D1, T2, D2, ET> dense_type;
+        typedef typename dense_type::engine_t engine_t;
+        typedef typename dense_type::gather_type gather_type;
+        typedef typename dense_type::output_type output_type;
+        typedef typename dense_type::output_element output_element;
+        typedef std::array<gather_type, dense_type::elements_in> gathered_type;
+
+        enum { elements_in = dense_type::elements_in };
+        enum { lanes = dense_type::blocks_gather };
+
+        static_assert(!dense_type::input_layout::planar && (int)dense_type::output_layout::access == (int)INTERLEAVED,
+            "Indexed records and compact results are interleaved!");
+
+        sparse_transformation() : _input(nullptr), _indices(nullptr), _count(0) {}
+        sparse_transformation(const T1* input, T2* output, const uint32_t* indices, size_t count)
+        {
+            bind(input, output, indices, count);
+        }
+
+        // output holds count results; input records are dense_type::default_stride() bytes apart
+        void bind(const T1* input, T2* output, const uint32_t* indices, size_t count)
+        {
+            _input = input + dense_type::default_offset() / sizeof(T1);
+            _stride = dense_type::default_stride() / sizeof(T1);
+            _indices = indices;
+            _count = count;
+            _results = output;
+            _output.bind(nullptr, output, count / lanes * lanes);
+        }
+
+        size_t size() const { return _count; }
+        size_t blocks() const { return _output.blocks(); }
+
+        static bool supported() { return dense_type::supported(); }
+
+        template<class T>
+        void apply(T action)
+        {
+            if (!supported())
+            {
+                std::cout << "Engine not supported!" << std::endl;
+                return;
+            }
+            if (blocks()) action(*this);
+
+            const size_t whole = blocks() * lanes, rest = _count - whole;
+            if (!rest) return;
+
+            uint32_t padded[lanes];
+            for (size_t i = 0; i < lanes; i++)
+                padded[i] = _indices[whole + std::min(i, rest - 1)];
+            output_element scratch[lanes];
+
+            sparse_transformation tail(*this);
+            tail._indices = padded;
+            tail._output.bind(nullptr, reinterpret_cast<T2*>(scratch), lanes);
+            action(tail);
+            std::copy(scratch, scratch + rest, reinterpret_cast<output_element*>(_results) + whole);
+        }
+
+        class iterator
+        {
+        public:
+            FORCEINLINE iterator(sparse_transformation* owner, size_t index) : _owner(owner), _index(index) {}
+            FORCEINLINE iterator& operator++() { ++_index; return *this; }
+            FORCEINLINE bool operator==(const iterator& other) const { return _index == other._index; }
+            FORCEINLINE bool operator!=(const iterator& other) const { return !(*this == other); }
+
+            FORCEINLINE iterator operator*() { return *this; }
+
+            FORCEINLINE gathered_type load() const
+            {
+                vector<engine_t, T1, elements_in> records;
+                engine_t::template indexed_utils<T1, elements_in>::gather(
+                    _owner->_input, _owner->_indices + _index * lanes, _owner->_stride, records);
+
+                gathered_type result;
+                for (int i = 0; i < elements_in; i++)
+                    result[i].assign(0, records.fetch(i));
+                return result;
+            }
+            FORCEINLINE gathered_type gather(const gathered_type& records) const { return records; }
+
+            template<class T, class... A>
+            FORCEINLINE output_type scatter(const T& t, const A&... args) const
+            {
+                return output_iterator().scatter(t, args...);
+            }
+            FORCEINLINE void store(const output_type& val) { output_iterator().store(val); }
+
+        private:
+            FORCEINLINE typename dense_type::iterator output_iterator() const
+            {
+                return typename dense_type::iterator(&_owner->_output, _index);
+            }
+
+            sparse_transformation* _owner;
+            size_t _index;
+        };
+
+        FORCEINLINE iterator begin() { return iterator(this, 0); }
+        FORCEINLINE iterator end() { return iterator(this, blocks()); }
+
+    private:
+        const T1* _input;
+        size_t _stride; // Scalars between consecutive input records
+        const uint32_t* _indices;
+        size_t _count;
+        T2* _results;
+        dense_type _output; // Compact results, whole registers only
+    };
+}
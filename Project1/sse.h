@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core.h"
+#include "formats.h"
 
 #include "sse_shuffle.h"
 #include "sse_operators.h"
@@ -15,6 +16,8 @@ namespace simd
     {
         static bool can_run()  { return true; }
 
+        enum { registers = SIMD_VECTOR_REGISTERS };
+
         template<typename T, typename Dummy = int>
         struct native_simd {};
 
@@ -62,6 +65,50 @@ namespace simd
             {
                 return native_simd(_mm_mul_ps(_data, y._data));
             }
+            // No FMA on plain SSE hardware, a * b + c
+            FORCEINLINE static native_simd fmadd(const native_simd& a, const native_simd& b, const native_simd& c)
+            {
+                return native_simd(_mm_add_ps(_mm_mul_ps(a._data, b._data), c._data));
+            }
+
+            FORCEINLINE static native_simd min(const native_simd& a, const native_simd& b)
+            {
+                return native_simd(_mm_min_ps(a._data, b._data));
+            }
+            FORCEINLINE static native_simd max(const native_simd& a, const native_simd& b)
+            {
+                return native_simd(_mm_max_ps(a._data, b._data));
+            }
+            FORCEINLINE static native_simd sqrt(const native_simd& a)
+            {
+                return native_simd(_mm_sqrt_ps(a._data));
+            }
+
+            // Masks have all bits of a lane set
+            FORCEINLINE static native_simd greater(const native_simd& a, const native_simd& b)
+            {
+                return native_simd(_mm_cmpgt_ps(a._data, b._data));
+            }
+            FORCEINLINE static native_simd less(const native_simd& a, const native_simd& b)
+            {
+                return native_simd(_mm_cmplt_ps(a._data, b._data));
+            }
+            FORCEINLINE static native_simd select(const native_simd& mask, const native_simd& a, const native_simd& b)
+            {
+                return native_simd(_mm_or_ps(_mm_and_ps(mask._data, a._data), _mm_andnot_ps(mask._data, b._data)));
+            }
+
+            // Masks to and from one bit per lane, lane 0 in bit 0
+            FORCEINLINE static int movemask(const native_simd& mask)
+            {
+                return _mm_movemask_ps(mask._data);
+            }
+            FORCEINLINE static native_simd mask_from_bits(int bits)
+            {
+                const __m128i lane_bits = _mm_setr_epi32(1, 2, 4, 8);
+                const __m128i set = _mm_and_si128(_mm_set1_epi32(bits), lane_bits);
+                return native_simd(_mm_castsi128_ps(_mm_cmpeq_epi32(set, lane_bits)));
+            }
             FORCEINLINE void store(underlying_type* ptr) const
             {
                 _mm_storeu_ps((float*)ptr, _data);
@@ -72,6 +119,142 @@ namespace simd
             underlying_type _data;
         };
 
+        template<typename Dummy>
+        struct native_simd<double, Dummy>
+        {
+        public:
+            typedef __m128d underlying_type;
+            typedef native_simd<double> representation_type;
+            typedef native_simd<double> this_type;
+
+            FORCEINLINE static void load(representation_type& target, const underlying_type* other)
+            {
+                target._data = _mm_loadu_pd((const double*)other);
+            }
+
+            FORCEINLINE static void store(const representation_type& src, underlying_type* target)
+            {
+                _mm_storeu_pd((double*)target, src._data);
+            }
+
+            FORCEINLINE static underlying_type vectorize(double x)
+            {
+                return _mm_set1_pd(x);
+            }
+
+            FORCEINLINE native_simd(underlying_type data) : _data(data) {}
+            FORCEINLINE native_simd(const underlying_type* data) : _data(_mm_loadu_pd((const double*)data)) {}
+            FORCEINLINE native_simd() : _data(_mm_setzero_pd()) {}
+            FORCEINLINE native_simd(const native_simd& data) { _data = data._data; }
+
+            FORCEINLINE native_simd operator+(const native_simd& y) const
+            {
+                return native_simd(_mm_add_pd(_data, y._data));
+            }
+            FORCEINLINE native_simd operator-(const native_simd& y) const
+            {
+                return native_simd(_mm_sub_pd(_data, y._data));
+            }
+            FORCEINLINE native_simd operator/(const native_simd& y) const
+            {
+                return native_simd(_mm_div_pd(_data, y._data));
+            }
+            FORCEINLINE native_simd operator*(const native_simd& y) const
+            {
+                return native_simd(_mm_mul_pd(_data, y._data));
+            }
+            FORCEINLINE static native_simd fmadd(const native_simd& a, const native_simd& b, const native_simd& c)
+            {
+                return native_simd(_mm_add_pd(_mm_mul_pd(a._data, b._data), c._data));
+            }
+
+            FORCEINLINE static native_simd min(const native_simd& a, const native_simd& b)
+            {
+                return native_simd(_mm_min_pd(a._data, b._data));
+            }
+            FORCEINLINE static native_simd max(const native_simd& a, const native_simd& b)
+            {
+                return native_simd(_mm_max_pd(a._data, b._data));
+            }
+            FORCEINLINE static native_simd sqrt(const native_simd& a)
+            {
+                return native_simd(_mm_sqrt_pd(a._data));
+            }
+
+            FORCEINLINE static native_simd greater(const native_simd& a, const native_simd& b)
+            {
+                return native_simd(_mm_cmpgt_pd(a._data, b._data));
+            }
+            FORCEINLINE static native_simd less(const native_simd& a, const native_simd& b)
+            {
+                return native_simd(_mm_cmplt_pd(a._data, b._data));
+            }
+            FORCEINLINE static native_simd select(const native_simd& mask, const native_simd& a, const native_simd& b)
+            {
+                return native_simd(_mm_or_pd(_mm_and_pd(mask._data, a._data), _mm_andnot_pd(mask._data, b._data)));
+            }
+            FORCEINLINE void store(underlying_type* ptr) const
+            {
+                _mm_storeu_pd((double*)ptr, _data);
+            }
+            FORCEINLINE operator underlying_type() const { return _data; }
+
+        private:
+            underlying_type _data;
+        };
+
+        // Sixteen byte lanes, for packed pixels. Only what moving bytes around needs,
+        // the color math widens to 16 bits in yuv_utils
+        template<typename Dummy>
+        struct native_simd<uint8_t, Dummy>
+        {
+        public:
+            typedef __m128i underlying_type;
+            typedef native_simd<uint8_t> representation_type;
+            typedef native_simd<uint8_t> this_type;
+
+            FORCEINLINE static void load(representation_type& target, const underlying_type* other)
+            {
+                target._data = _mm_loadu_si128(other);
+            }
+
+            FORCEINLINE static void store(const representation_type& src, underlying_type* target)
+            {
+                _mm_storeu_si128(target, src._data);
+            }
+
+            FORCEINLINE static underlying_type vectorize(uint8_t x)
+            {
+                return _mm_set1_epi8((char)x);
+            }
+
+            FORCEINLINE native_simd(underlying_type data) : _data(data) {}
+            FORCEINLINE native_simd(const underlying_type* data) : _data(_mm_loadu_si128(data)) {}
+            FORCEINLINE native_simd() : _data(_mm_setzero_si128()) {}
+            FORCEINLINE native_simd(const native_simd& data) { _data = data._data; }
+
+            FORCEINLINE static native_simd min(const native_simd& a, const native_simd& b)
+            {
+                return native_simd(_mm_min_epu8(a._data, b._data));
+            }
+            FORCEINLINE static native_simd max(const native_simd& a, const native_simd& b)
+            {
+                return native_simd(_mm_max_epu8(a._data, b._data));
+            }
+            FORCEINLINE static native_simd select(const native_simd& mask, const native_simd& a, const native_simd& b)
+            {
+                return native_simd(_mm_or_si128(_mm_and_si128(mask._data, a._data), _mm_andnot_si128(mask._data, b._data)));
+            }
+            FORCEINLINE void store(underlying_type* ptr) const
+            {
+                _mm_storeu_si128(ptr, _data);
+            }
+            FORCEINLINE operator underlying_type() const { return _data; }
+
+        private:
+            underlying_type _data;
+        };
+
         static __m128i load_mask(unsigned int x)
         {
             return  _mm_set_epi32(
@@ -81,6 +264,13 @@ namespace simd
                 (x & 0x000000ff) ? 0xffffffff : 0);
         }
 
+        static __m128d load_mask_pd(unsigned int x)
+        {
+            return _mm_castsi128_pd(_mm_set_epi64x(
+                (x & 0xff00) ? -1 : 0,
+                (x & 0x00ff) ? -1 : 0));
+        }
+
         template<class T, unsigned int START, unsigned int GAP>
         struct gather_utils {};
 
@@ -182,6 +372,288 @@ namespace simd
                 scatter_loop<OT, ST, OT::blocks>::scatter(output_block, curr_var);
             }
         };
+
+        // Two double lanes per register, same tables scheme as float
+        template<unsigned int START, unsigned int GAP>
+        struct gather_utils<double, START, GAP>
+        {
+            template<class GT, class QT, unsigned int J>
+            struct gather_loop
+            {
+                static void gather(const QT& res, GT& result)
+                {
+                    typedef sse::gather_shuffle_pd<GAP, START, J - 1> table;
+                    auto s1 = res.fetch(J - 1);
+                    auto res1 = _mm_and_pd(_mm_shuffle_pd(s1, s1, table::shuffle), load_mask_pd(table::mask()));
+                    result.assign(0, _mm_or_pd(res1, result.fetch(0)));
+                    gather_loop<GT, QT, J - 1>::gather(res, result);
+                }
+            };
+            template<class GT, class QT>
+            struct gather_loop<GT, QT, 0>
+            {
+                static void gather(const QT& res, GT& result) {}
+            };
+
+            template<class GT, class QT>
+            static void gather(const QT& res, GT& result)
+            {
+                gather_loop<GT, QT, QT::blocks>::gather(res, result);
+            }
+        };
+
+        template<unsigned int START, unsigned int GAP>
+        struct scatter_utils<double, START, GAP>
+        {
+            template<class OT, class ST, unsigned int J>
+            struct scatter_loop
+            {
+                static void scatter(OT& output_block, const ST& curr_var)
+                {
+                    typedef sse::scatter_shuffle_pd<GAP, START, J - 1> table;
+                    auto s1 = curr_var.fetch(0);
+                    auto res1 = _mm_and_pd(_mm_shuffle_pd(s1, s1, table::shuffle), load_mask_pd(table::mask()));
+                    output_block.assign(J - 1, _mm_or_pd(res1, output_block.fetch(J - 1)));
+                    scatter_loop<OT, ST, J - 1>::scatter(output_block, curr_var);
+                }
+            };
+            template<class OT, class ST>
+            struct scatter_loop<OT, ST, 0>
+            {
+                static void scatter(OT& output_block, const ST& curr_var) {}
+            };
+
+            template<class OT, class ST>
+            static void scatter(OT& output_block, const ST& curr_var)
+            {
+                scatter_loop<OT, ST, OT::blocks>::scatter(output_block, curr_var);
+            }
+        };
+
+        // Bytes go through pshufb, one shuffle per register of the block that holds any
+        // of the component, merged with or (the shuffles zero every other byte)
+        template<unsigned int START, unsigned int GAP>
+        struct gather_utils<uint8_t, START, GAP>
+        {
+            template<class GT, class QT, unsigned int J>
+            struct gather_loop
+            {
+                static void gather(const QT& res, GT& result)
+                {
+                    typedef sse::gather_shuffle_epi8<GAP, START, J - 1> table;
+                    if (table::used)
+                        result.assign(0, _mm_or_si128(_mm_shuffle_epi8(res.fetch(J - 1), table::shuffle()), result.fetch(0)));
+                    gather_loop<GT, QT, J - 1>::gather(res, result);
+                }
+            };
+            template<class GT, class QT>
+            struct gather_loop<GT, QT, 0>
+            {
+                static void gather(const QT& res, GT& result) {}
+            };
+
+            template<class GT, class QT>
+            static void gather(const QT& res, GT& result)
+            {
+                gather_loop<GT, QT, QT::blocks>::gather(res, result);
+            }
+        };
+
+        template<unsigned int START, unsigned int GAP>
+        struct scatter_utils<uint8_t, START, GAP>
+        {
+            template<class OT, class ST, unsigned int J>
+            struct scatter_loop
+            {
+                static void scatter(OT& output_block, const ST& curr_var)
+                {
+                    typedef sse::scatter_shuffle_epi8<GAP, START, J - 1> table;
+                    if (table::used)
+                        output_block.assign(J - 1, _mm_or_si128(_mm_shuffle_epi8(curr_var.fetch(0), table::shuffle()), output_block.fetch(J - 1)));
+                    scatter_loop<OT, ST, J - 1>::scatter(output_block, curr_var);
+                }
+            };
+            template<class OT, class ST>
+            struct scatter_loop<OT, ST, 0>
+            {
+                static void scatter(OT& output_block, const ST& curr_var) {}
+            };
+
+            template<class OT, class ST>
+            static void scatter(OT& output_block, const ST& curr_var)
+            {
+                scatter_loop<OT, ST, OT::blocks>::scatter(output_block, curr_var);
+            }
+        };
+
+        template<class T, unsigned int COMPONENTS>
+        struct strided_utils {};
+
+        template<unsigned int COMPONENTS>
+        struct strided_utils<float, COMPONENTS>
+        {
+            // Four records, four floats each from the field on, transposed into
+            // one register per component. Needs 4 readable floats in every record.
+            template<class VT>
+            FORCEINLINE static void transpose(const float* base, size_t stride, VT& result)
+            {
+                __m128 r0 = _mm_loadu_ps(base);
+                __m128 r1 = _mm_loadu_ps(base + stride);
+                __m128 r2 = _mm_loadu_ps(base + 2 * stride);
+                __m128 r3 = _mm_loadu_ps(base + 3 * stride);
+                _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+                const __m128 rows[4] = { r0, r1, r2, r3 };
+                for (unsigned int i = 0; i < COMPONENTS && i < 4; i++)
+                    result.assign(i, rows[i]);
+            }
+
+            template<class VT>
+            FORCEINLINE static void insert(const float* base, size_t stride, VT& result)
+            {
+                for (unsigned int i = 0; i < COMPONENTS; i++)
+                    result.assign(i, _mm_set_ps(base[3 * stride + i], base[2 * stride + i], base[stride + i], base[i]));
+            }
+
+            template<unsigned int STRIDE, bool FITS, class VT>
+            FORCEINLINE static void gather(const float* base, VT& result)
+            {
+                if (FITS) transpose(base, STRIDE, result);
+                else insert(base, STRIDE, result);
+            }
+
+            // No hardware gather before AVX2
+            template<class VT>
+            FORCEINLINE static void gather(const float* base, size_t stride, bool fits, VT& result)
+            {
+                if (fits) transpose(base, stride, result);
+                else insert(base, stride, result);
+            }
+        };
+
+        template<class T, unsigned int COMPONENTS>
+        struct indexed_utils {};
+
+        // Records indices[0..3], records stride scalars apart. No hardware gather before
+        // AVX2, lanes are inserted one by one
+        template<unsigned int COMPONENTS>
+        struct indexed_utils<float, COMPONENTS>
+        {
+            template<class VT>
+            FORCEINLINE static void gather(const float* base, const uint32_t* indices, size_t stride, VT& result)
+            {
+                const float* r0 = base + indices[0] * stride;
+                const float* r1 = base + indices[1] * stride;
+                const float* r2 = base + indices[2] * stride;
+                const float* r3 = base + indices[3] * stride;
+                for (unsigned int i = 0; i < COMPONENTS; i++)
+                    result.assign(i, _mm_set_ps(r3[i], r2[i], r1[i], r0[i]));
+            }
+        };
+
+        // BT.601 limited range YUV to RGB in 6-bit fixed point, the arithmetic of
+        // engine<NAIVE>::yuv_utils on eight 16-bit lanes at a time
+        struct yuv_utils
+        {
+            FORCEINLINE static void to_rgb(__m128i y, __m128i u, __m128i v, __m128i& r, __m128i& g, __m128i& b)
+            {
+                const __m128i zero = _mm_setzero_si128();
+                __m128i r0, g0, b0, r1, g1, b1;
+                // y * 257 is y in both bytes of the 16-bit lane
+                to_rgb16(_mm_unpacklo_epi8(y, y), _mm_unpacklo_epi8(u, zero), _mm_unpacklo_epi8(v, zero), r0, g0, b0);
+                to_rgb16(_mm_unpackhi_epi8(y, y), _mm_unpackhi_epi8(u, zero), _mm_unpackhi_epi8(v, zero), r1, g1, b1);
+                r = _mm_packus_epi16(r0, r1);
+                g = _mm_packus_epi16(g0, g1);
+                b = _mm_packus_epi16(b0, b1);
+            }
+
+        private:
+            FORCEINLINE static void to_rgb16(__m128i y257, __m128i u, __m128i v, __m128i& r, __m128i& g, __m128i& b)
+            {
+                const __m128i luma = _mm_mulhi_epu16(y257, _mm_set1_epi16(18997));
+                const __m128i bias = _mm_set1_epi16(-1160);
+                const __m128i d = _mm_sub_epi16(u, _mm_set1_epi16(128));
+                const __m128i e = _mm_sub_epi16(v, _mm_set1_epi16(128));
+                const __m128i chroma_g = _mm_add_epi16(_mm_mullo_epi16(d, _mm_set1_epi16(-25)), _mm_mullo_epi16(e, _mm_set1_epi16(-52)));
+                r = _mm_srai_epi16(_mm_adds_epi16(_mm_adds_epi16(luma, _mm_mullo_epi16(e, _mm_set1_epi16(102))), bias), 6);
+                g = _mm_srai_epi16(_mm_adds_epi16(_mm_adds_epi16(luma, chroma_g), bias), 6);
+                b = _mm_srai_epi16(_mm_adds_epi16(_mm_adds_epi16(luma, _mm_mullo_epi16(d, _mm_set1_epi16(129))), bias), 6);
+            }
+        };
+
+        // Four 32-bit lanes that hold 16-bit values (sign extended or not) down
+        // to four uint16, without the SSE4.1 unsigned pack
+        FORCEINLINE static void store_low16(__m128i x, uint16_t* target)
+        {
+            x = _mm_srai_epi32(_mm_slli_epi32(x, 16), 16);
+            _mm_storel_epi64((__m128i*)target, _mm_packs_epi32(x, x));
+        }
+
+        // 16-bit storage formats. F16C came with AVX, so fp16 goes lane by lane here
+        template<class F>
+        struct format_utils
+        {
+            FORCEINLINE static void encode(__m128 value, uint16_t* target)
+            {
+                float lanes[4];
+                _mm_storeu_ps(lanes, value);
+                for (int i = 0; i < 4; i++) target[i] = F::encode(lanes[i]);
+            }
+            FORCEINLINE static __m128 decode(const uint16_t* source)
+            {
+                return _mm_set_ps(F::decode(source[3]), F::decode(source[2]), F::decode(source[1]), F::decode(source[0]));
+            }
+        };
+    };
+
+    template<>
+    struct engine<DEFAULT>::format_utils<bf16>
+    {
+        FORCEINLINE static void encode(__m128 value, uint16_t* target)
+        {
+            const __m128i bits = _mm_castps_si128(value);
+            const __m128i nan = _mm_castps_si128(_mm_cmpunord_ps(value, value));
+            const __m128i lsb = _mm_and_si128(_mm_srli_epi32(bits, 16), _mm_set1_epi32(1));
+            const __m128i bias = _mm_andnot_si128(nan, _mm_add_epi32(_mm_set1_epi32(0x7FFF), lsb));
+            const __m128i quiet = _mm_and_si128(nan, _mm_set1_epi32(0x400000));
+            engine<DEFAULT>::store_low16(_mm_srli_epi32(_mm_or_si128(_mm_add_epi32(bits, bias), quiet), 16), target);
+        }
+        FORCEINLINE static __m128 decode(const uint16_t* source)
+        {
+            const __m128i x = _mm_loadl_epi64((const __m128i*)source);
+            return _mm_castsi128_ps(_mm_unpacklo_epi16(_mm_setzero_si128(), x));
+        }
+    };
+
+    template<>
+    struct engine<DEFAULT>::format_utils<unorm16>
+    {
+        FORCEINLINE static void encode(__m128 value, uint16_t* target)
+        {
+            const __m128 clamped = _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set_ps1(1.f));
+            const __m128 scaled = _mm_add_ps(_mm_mul_ps(clamped, _mm_set_ps1(65535.f)), _mm_set_ps1(0.5f));
+            engine<DEFAULT>::store_low16(_mm_cvttps_epi32(scaled), target);
+        }
+        FORCEINLINE static __m128 decode(const uint16_t* source)
+        {
+            const __m128i x = _mm_loadl_epi64((const __m128i*)source);
+            return _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(x, _mm_setzero_si128())), _mm_set_ps1(1.f / 65535.f));
+        }
+    };
+
+    template<>
+    struct engine<DEFAULT>::format_utils<depth16>
+    {
+        FORCEINLINE static void encode(__m128 value, uint16_t* target)
+        {
+            const __m128 clamped = _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set_ps1(65535.f));
+            engine<DEFAULT>::store_low16(_mm_cvttps_epi32(_mm_add_ps(clamped, _mm_set_ps1(0.5f))), target);
+        }
+        FORCEINLINE static __m128 decode(const uint16_t* source)
+        {
+            const __m128i x = _mm_loadl_epi64((const __m128i*)source);
+            return _mm_cvtepi32_ps(_mm_unpacklo_epi16(x, _mm_setzero_si128()));
+        }
     };
 
 }
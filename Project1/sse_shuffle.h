@@ -2,6 +2,8 @@
 
 #include <tmmintrin.h>
 
+#include "core.h"
+
 #define SET_SCATTER_SHUFFLE(G, O, L, S, M) \
 template<>\
 struct scatter_shuffle<G, O, L>\
@@ -18,6 +20,23 @@ struct gather_shuffle<G, O, L>\
     static constexpr unsigned int mask() { return M; }\
 }
 
+// Double lanes: shuffle() is the immediate of _mm_shuffle_pd
+#define SET_SCATTER_SHUFFLE_PD(G, O, L, S, M) \
+template<>\
+struct scatter_shuffle_pd<G, O, L>\
+{\
+    enum { shuffle = S };\
+    static constexpr unsigned int mask() { return M; }\
+}
+
+#define SET_GATHER_SHUFFLE_PD(G, O, L, S, M) \
+template<>\
+struct gather_shuffle_pd<G, O, L>\
+{\
+    enum { shuffle = S };\
+    static constexpr unsigned int mask() { return M; }\
+}
+
 namespace simd
 {
     namespace sse
@@ -27,115 +46,224 @@ namespace simd
         template<int GAP, int OFFSET, int LINE>
         struct gather_shuffle {};
 
+        SET_SCATTER_SHUFFLE(1, 0, 0, _MM_SHUFFLE(3, 2, 1, 0), 0xFFFFFFFF);
+        SET_GATHER_SHUFFLE(1, 0, 0, _MM_SHUFFLE(3, 2, 1, 0), 0xFFFFFFFF);
         SET_SCATTER_SHUFFLE(2, 0, 0, _MM_SHUFFLE(0, 1, 0, 0), 0x00FF00FF);
-        SET_GATHER_SHUFFLE(2, 0, 0, _MM_SHUFFLE(0, 0, 2, 0), 0x00FEFF01);
+        SET_GATHER_SHUFFLE(2, 0, 0, _MM_SHUFFLE(0, 0, 2, 0), 0x0000FFFF);
         SET_SCATTER_SHUFFLE(2, 0, 1, _MM_SHUFFLE(0, 3, 0, 2), 0x00FF00FF);
-        SET_GATHER_SHUFFLE(2, 0, 1, _MM_SHUFFLE(2, 0, 0, 0), 0xFF010000);
+        SET_GATHER_SHUFFLE(2, 0, 1, _MM_SHUFFLE(2, 0, 0, 0), 0xFFFF0000);
         SET_SCATTER_SHUFFLE(2, 1, 0, _MM_SHUFFLE(1, 0, 0, 0), 0xFF00FF00);
-        SET_GATHER_SHUFFLE(2, 1, 0, _MM_SHUFFLE(0, 0, 3, 1), 0x00FEFF01);
+        SET_GATHER_SHUFFLE(2, 1, 0, _MM_SHUFFLE(0, 0, 3, 1), 0x0000FFFF);
         SET_SCATTER_SHUFFLE(2, 1, 1, _MM_SHUFFLE(3, 0, 2, 0), 0xFF00FF00);
-        SET_GATHER_SHUFFLE(2, 1, 1, _MM_SHUFFLE(3, 1, 0, 0), 0xFF010000);
+        SET_GATHER_SHUFFLE(2, 1, 1, _MM_SHUFFLE(3, 1, 0, 0), 0xFFFF0000);
         SET_SCATTER_SHUFFLE(3, 0, 0, _MM_SHUFFLE(1, 0, 0, 0), 0xFF0000FF);
-        SET_GATHER_SHUFFLE(3, 0, 0, _MM_SHUFFLE(0, 0, 3, 0), 0x00FEFF01);
+        SET_GATHER_SHUFFLE(3, 0, 0, _MM_SHUFFLE(0, 0, 3, 0), 0x0000FFFF);
         SET_SCATTER_SHUFFLE(3, 0, 1, _MM_SHUFFLE(0, 2, 0, 0), 0x00FF0000);
-        SET_GATHER_SHUFFLE(3, 0, 1, _MM_SHUFFLE(0, 0, 0, 3), 0x0000FE01);
+        SET_GATHER_SHUFFLE(3, 0, 1, _MM_SHUFFLE(0, 2, 0, 0), 0x00FF0000);
         SET_SCATTER_SHUFFLE(3, 0, 2, _MM_SHUFFLE(0, 0, 3, 0), 0x0000FF00);
-        SET_GATHER_SHUFFLE(3, 0, 2, _MM_SHUFFLE(0, 0, 0, 3), 0x0000FE01);
+        SET_GATHER_SHUFFLE(3, 0, 2, _MM_SHUFFLE(1, 0, 0, 0), 0xFF000000);
         SET_SCATTER_SHUFFLE(3, 1, 0, _MM_SHUFFLE(0, 0, 0, 0), 0x0000FF00);
-        SET_GATHER_SHUFFLE(3, 1, 0, _MM_SHUFFLE(0, 0, 0, 1), 0x0000FE01);
+        SET_GATHER_SHUFFLE(3, 1, 0, _MM_SHUFFLE(0, 0, 0, 1), 0x000000FF);
         SET_SCATTER_SHUFFLE(3, 1, 1, _MM_SHUFFLE(2, 0, 0, 1), 0xFF0000FF);
-        SET_GATHER_SHUFFLE(3, 1, 1, _MM_SHUFFLE(0, 0, 0, 1), 0x0000FE01);
+        SET_GATHER_SHUFFLE(3, 1, 1, _MM_SHUFFLE(0, 3, 0, 0), 0x00FFFF00);
         SET_SCATTER_SHUFFLE(3, 1, 2, _MM_SHUFFLE(0, 3, 0, 0), 0x00FF0000);
-        SET_GATHER_SHUFFLE(3, 1, 2, _MM_SHUFFLE(0, 0, 0, 1), 0x0000FE01);
+        SET_GATHER_SHUFFLE(3, 1, 2, _MM_SHUFFLE(2, 0, 0, 0), 0xFF000000);
         SET_SCATTER_SHUFFLE(3, 2, 0, _MM_SHUFFLE(0, 0, 0, 0), 0x00FF0000);
-        SET_GATHER_SHUFFLE(3, 2, 0, _MM_SHUFFLE(0, 0, 0, 2), 0x0000FE01);
+        SET_GATHER_SHUFFLE(3, 2, 0, _MM_SHUFFLE(0, 0, 0, 2), 0x000000FF);
         SET_SCATTER_SHUFFLE(3, 2, 1, _MM_SHUFFLE(0, 0, 1, 0), 0x0000FF00);
-        SET_GATHER_SHUFFLE(3, 2, 1, _MM_SHUFFLE(0, 0, 0, 2), 0x0000FE01);
+        SET_GATHER_SHUFFLE(3, 2, 1, _MM_SHUFFLE(0, 0, 1, 0), 0x0000FF00);
         SET_SCATTER_SHUFFLE(3, 2, 2, _MM_SHUFFLE(3, 0, 0, 2), 0xFF0000FF);
-        SET_GATHER_SHUFFLE(3, 2, 2, _MM_SHUFFLE(0, 0, 0, 2), 0x0000FE01);
+        SET_GATHER_SHUFFLE(3, 2, 2, _MM_SHUFFLE(3, 0, 0, 0), 0xFFFF0000);
         SET_SCATTER_SHUFFLE(4, 0, 0, _MM_SHUFFLE(0, 0, 0, 0), 0x000000FF);
-        SET_GATHER_SHUFFLE(4, 0, 0, _MM_SHUFFLE(0, 0, 0, 0), 0x0000FE01);
+        SET_GATHER_SHUFFLE(4, 0, 0, _MM_SHUFFLE(0, 0, 0, 0), 0x000000FF);
         SET_SCATTER_SHUFFLE(4, 0, 1, _MM_SHUFFLE(0, 0, 0, 1), 0x000000FF);
-        SET_GATHER_SHUFFLE(4, 0, 1, _MM_SHUFFLE(0, 0, 0, 0), 0x00FE0100);
+        SET_GATHER_SHUFFLE(4, 0, 1, _MM_SHUFFLE(0, 0, 0, 0), 0x0000FF00);
         SET_SCATTER_SHUFFLE(4, 0, 2, _MM_SHUFFLE(0, 0, 0, 2), 0x000000FF);
-        SET_GATHER_SHUFFLE(4, 0, 2, _MM_SHUFFLE(0, 0, 0, 0), 0xFE010000);
+        SET_GATHER_SHUFFLE(4, 0, 2, _MM_SHUFFLE(0, 0, 0, 0), 0x00FF0000);
         SET_SCATTER_SHUFFLE(4, 0, 3, _MM_SHUFFLE(0, 0, 0, 3), 0x000000FF);
-        SET_GATHER_SHUFFLE(4, 0, 3, _MM_SHUFFLE(0, 0, 0, 0), 0x01000000);
+        SET_GATHER_SHUFFLE(4, 0, 3, _MM_SHUFFLE(0, 0, 0, 0), 0xFF000000);
         SET_SCATTER_SHUFFLE(4, 1, 0, _MM_SHUFFLE(0, 0, 0, 0), 0x0000FF00);
-        SET_GATHER_SHUFFLE(4, 1, 0, _MM_SHUFFLE(0, 0, 0, 1), 0x0000FE01);
+        SET_GATHER_SHUFFLE(4, 1, 0, _MM_SHUFFLE(0, 0, 0, 1), 0x000000FF);
         SET_SCATTER_SHUFFLE(4, 1, 1, _MM_SHUFFLE(0, 0, 1, 0), 0x0000FF00);
-        SET_GATHER_SHUFFLE(4, 1, 1, _MM_SHUFFLE(0, 0, 1, 0), 0x00FE0100);
+        SET_GATHER_SHUFFLE(4, 1, 1, _MM_SHUFFLE(0, 0, 1, 0), 0x0000FF00);
         SET_SCATTER_SHUFFLE(4, 1, 2, _MM_SHUFFLE(0, 0, 2, 0), 0x0000FF00);
-        SET_GATHER_SHUFFLE(4, 1, 2, _MM_SHUFFLE(0, 1, 0, 0), 0xFE010000);
+        SET_GATHER_SHUFFLE(4, 1, 2, _MM_SHUFFLE(0, 1, 0, 0), 0x00FF0000);
         SET_SCATTER_SHUFFLE(4, 1, 3, _MM_SHUFFLE(0, 0, 3, 0), 0x0000FF00);
-        SET_GATHER_SHUFFLE(4, 1, 3, _MM_SHUFFLE(1, 0, 0, 0), 0x01000000);
+        SET_GATHER_SHUFFLE(4, 1, 3, _MM_SHUFFLE(1, 0, 0, 0), 0xFF000000);
         SET_SCATTER_SHUFFLE(4, 2, 0, _MM_SHUFFLE(0, 0, 0, 0), 0x00FF0000);
-        SET_GATHER_SHUFFLE(4, 2, 0, _MM_SHUFFLE(0, 0, 0, 2), 0x0000FE01);
+        SET_GATHER_SHUFFLE(4, 2, 0, _MM_SHUFFLE(0, 0, 0, 2), 0x000000FF);
         SET_SCATTER_SHUFFLE(4, 2, 1, _MM_SHUFFLE(0, 1, 0, 0), 0x00FF0000);
-        SET_GATHER_SHUFFLE(4, 2, 1, _MM_SHUFFLE(0, 0, 2, 0), 0x00FE0100);
+        SET_GATHER_SHUFFLE(4, 2, 1, _MM_SHUFFLE(0, 0, 2, 0), 0x0000FF00);
         SET_SCATTER_SHUFFLE(4, 2, 2, _MM_SHUFFLE(0, 2, 0, 0), 0x00FF0000);
-        SET_GATHER_SHUFFLE(4, 2, 2, _MM_SHUFFLE(0, 2, 0, 0), 0xFE010000);
+        SET_GATHER_SHUFFLE(4, 2, 2, _MM_SHUFFLE(0, 2, 0, 0), 0x00FF0000);
         SET_SCATTER_SHUFFLE(4, 2, 3, _MM_SHUFFLE(0, 3, 0, 0), 0x00FF0000);
-        SET_GATHER_SHUFFLE(4, 2, 3, _MM_SHUFFLE(2, 0, 0, 0), 0x01000000);
+        SET_GATHER_SHUFFLE(4, 2, 3, _MM_SHUFFLE(2, 0, 0, 0), 0xFF000000);
         SET_SCATTER_SHUFFLE(4, 3, 0, _MM_SHUFFLE(0, 0, 0, 0), 0xFF000000);
-        SET_GATHER_SHUFFLE(4, 3, 0, _MM_SHUFFLE(0, 0, 0, 3), 0x0000FE01);
+        SET_GATHER_SHUFFLE(4, 3, 0, _MM_SHUFFLE(0, 0, 0, 3), 0x000000FF);
         SET_SCATTER_SHUFFLE(4, 3, 1, _MM_SHUFFLE(1, 0, 0, 0), 0xFF000000);
-        SET_GATHER_SHUFFLE(4, 3, 1, _MM_SHUFFLE(0, 0, 3, 0), 0x00FE0100);
+        SET_GATHER_SHUFFLE(4, 3, 1, _MM_SHUFFLE(0, 0, 3, 0), 0x0000FF00);
         SET_SCATTER_SHUFFLE(4, 3, 2, _MM_SHUFFLE(2, 0, 0, 0), 0xFF000000);
-        SET_GATHER_SHUFFLE(4, 3, 2, _MM_SHUFFLE(0, 3, 0, 0), 0xFE010000);
+        SET_GATHER_SHUFFLE(4, 3, 2, _MM_SHUFFLE(0, 3, 0, 0), 0x00FF0000);
         SET_SCATTER_SHUFFLE(4, 3, 3, _MM_SHUFFLE(3, 0, 0, 0), 0xFF000000);
-        SET_GATHER_SHUFFLE(4, 3, 3, _MM_SHUFFLE(3, 0, 0, 0), 0x01000000);
+        SET_GATHER_SHUFFLE(4, 3, 3, _MM_SHUFFLE(3, 0, 0, 0), 0xFF000000);
         SET_SCATTER_SHUFFLE(5, 0, 0, _MM_SHUFFLE(0, 0, 0, 0), 0x000000FF);
-        SET_GATHER_SHUFFLE(5, 0, 0, _MM_SHUFFLE(0, 0, 0, 0), 0x0000FE01);
+        SET_GATHER_SHUFFLE(5, 0, 0, _MM_SHUFFLE(0, 0, 0, 0), 0x000000FF);
         SET_SCATTER_SHUFFLE(5, 0, 1, _MM_SHUFFLE(0, 0, 1, 0), 0x0000FF00);
-        SET_GATHER_SHUFFLE(5, 0, 1, _MM_SHUFFLE(0, 0, 0, 0), 0x0000FE01);
+        SET_GATHER_SHUFFLE(5, 0, 1, _MM_SHUFFLE(0, 0, 1, 0), 0x0000FF00);
         SET_SCATTER_SHUFFLE(5, 0, 2, _MM_SHUFFLE(0, 2, 0, 0), 0x00FF0000);
-        SET_GATHER_SHUFFLE(5, 0, 2, _MM_SHUFFLE(0, 0, 0, 0), 0x0000FE01);
+        SET_GATHER_SHUFFLE(5, 0, 2, _MM_SHUFFLE(0, 2, 0, 0), 0x00FF0000);
         SET_SCATTER_SHUFFLE(5, 0, 3, _MM_SHUFFLE(3, 0, 0, 0), 0xFF000000);
-        SET_GATHER_SHUFFLE(5, 0, 3, _MM_SHUFFLE(0, 0, 0, 0), 0x0000FE01);
+        SET_GATHER_SHUFFLE(5, 0, 3, _MM_SHUFFLE(3, 0, 0, 0), 0xFF000000);
         SET_SCATTER_SHUFFLE(5, 0, 4, _MM_SHUFFLE(0, 0, 0, 0), 0x00000000);
-        SET_GATHER_SHUFFLE(5, 0, 4, _MM_SHUFFLE(0, 0, 0, 0), 0x0000FE01);
+        SET_GATHER_SHUFFLE(5, 0, 4, _MM_SHUFFLE(0, 0, 0, 0), 0x00000000);
         SET_SCATTER_SHUFFLE(5, 1, 0, _MM_SHUFFLE(0, 0, 0, 0), 0x0000FF00);
-        SET_GATHER_SHUFFLE(5, 1, 0, _MM_SHUFFLE(0, 0, 0, 1), 0x0000FE01);
+        SET_GATHER_SHUFFLE(5, 1, 0, _MM_SHUFFLE(0, 0, 0, 1), 0x000000FF);
         SET_SCATTER_SHUFFLE(5, 1, 1, _MM_SHUFFLE(0, 1, 0, 0), 0x00FF0000);
-        SET_GATHER_SHUFFLE(5, 1, 1, _MM_SHUFFLE(0, 0, 0, 1), 0x0000FE01);
+        SET_GATHER_SHUFFLE(5, 1, 1, _MM_SHUFFLE(0, 0, 2, 0), 0x0000FF00);
         SET_SCATTER_SHUFFLE(5, 1, 2, _MM_SHUFFLE(2, 0, 0, 0), 0xFF000000);
-        SET_GATHER_SHUFFLE(5, 1, 2, _MM_SHUFFLE(0, 0, 0, 1), 0x0000FE01);
+        SET_GATHER_SHUFFLE(5, 1, 2, _MM_SHUFFLE(0, 3, 0, 0), 0x00FF0000);
         SET_SCATTER_SHUFFLE(5, 1, 3, _MM_SHUFFLE(0, 0, 0, 0), 0x00000000);
-        SET_GATHER_SHUFFLE(5, 1, 3, _MM_SHUFFLE(0, 0, 0, 1), 0x0000FE01);
+        SET_GATHER_SHUFFLE(5, 1, 3, _MM_SHUFFLE(0, 0, 0, 0), 0x00000000);
         SET_SCATTER_SHUFFLE(5, 1, 4, _MM_SHUFFLE(0, 0, 0, 3), 0x000000FF);
-        SET_GATHER_SHUFFLE(5, 1, 4, _MM_SHUFFLE(0, 0, 0, 1), 0x0000FE01);
+        SET_GATHER_SHUFFLE(5, 1, 4, _MM_SHUFFLE(0, 0, 0, 0), 0xFF000000);
         SET_SCATTER_SHUFFLE(5, 2, 0, _MM_SHUFFLE(0, 0, 0, 0), 0x00FF0000);
-        SET_GATHER_SHUFFLE(5, 2, 0, _MM_SHUFFLE(0, 0, 0, 2), 0x0000FE01);
+        SET_GATHER_SHUFFLE(5, 2, 0, _MM_SHUFFLE(0, 0, 0, 2), 0x000000FF);
         SET_SCATTER_SHUFFLE(5, 2, 1, _MM_SHUFFLE(1, 0, 0, 0), 0xFF000000);
-        SET_GATHER_SHUFFLE(5, 2, 1, _MM_SHUFFLE(0, 0, 0, 2), 0x0000FE01);
+        SET_GATHER_SHUFFLE(5, 2, 1, _MM_SHUFFLE(0, 0, 3, 0), 0x0000FF00);
         SET_SCATTER_SHUFFLE(5, 2, 2, _MM_SHUFFLE(0, 0, 0, 0), 0x00000000);
-        SET_GATHER_SHUFFLE(5, 2, 2, _MM_SHUFFLE(0, 0, 0, 2), 0x0000FE01);
+        SET_GATHER_SHUFFLE(5, 2, 2, _MM_SHUFFLE(0, 0, 0, 0), 0x00000000);
         SET_SCATTER_SHUFFLE(5, 2, 3, _MM_SHUFFLE(0, 0, 0, 2), 0x000000FF);
-        SET_GATHER_SHUFFLE(5, 2, 3, _MM_SHUFFLE(0, 0, 0, 2), 0x0000FE01);
+        SET_GATHER_SHUFFLE(5, 2, 3, _MM_SHUFFLE(0, 0, 0, 0), 0x00FF0000);
         SET_SCATTER_SHUFFLE(5, 2, 4, _MM_SHUFFLE(0, 0, 3, 0), 0x0000FF00);
-        SET_GATHER_SHUFFLE(5, 2, 4, _MM_SHUFFLE(0, 0, 0, 2), 0x0000FE01);
+        SET_GATHER_SHUFFLE(5, 2, 4, _MM_SHUFFLE(1, 0, 0, 0), 0xFF000000);
         SET_SCATTER_SHUFFLE(5, 3, 0, _MM_SHUFFLE(0, 0, 0, 0), 0xFF000000);
-        SET_GATHER_SHUFFLE(5, 3, 0, _MM_SHUFFLE(0, 0, 0, 3), 0x0000FE01);
+        SET_GATHER_SHUFFLE(5, 3, 0, _MM_SHUFFLE(0, 0, 0, 3), 0x000000FF);
         SET_SCATTER_SHUFFLE(5, 3, 1, _MM_SHUFFLE(0, 0, 0, 0), 0x00000000);
-        SET_GATHER_SHUFFLE(5, 3, 1, _MM_SHUFFLE(0, 0, 0, 3), 0x0000FE01);
+        SET_GATHER_SHUFFLE(5, 3, 1, _MM_SHUFFLE(0, 0, 0, 0), 0x00000000);
         SET_SCATTER_SHUFFLE(5, 3, 2, _MM_SHUFFLE(0, 0, 0, 1), 0x000000FF);
-        SET_GATHER_SHUFFLE(5, 3, 2, _MM_SHUFFLE(0, 0, 0, 3), 0x0000FE01);
+        SET_GATHER_SHUFFLE(5, 3, 2, _MM_SHUFFLE(0, 0, 0, 0), 0x0000FF00);
         SET_SCATTER_SHUFFLE(5, 3, 3, _MM_SHUFFLE(0, 0, 2, 0), 0x0000FF00);
-        SET_GATHER_SHUFFLE(5, 3, 3, _MM_SHUFFLE(0, 0, 0, 3), 0x0000FE01);
+        SET_GATHER_SHUFFLE(5, 3, 3, _MM_SHUFFLE(0, 1, 0, 0), 0x00FF0000);
         SET_SCATTER_SHUFFLE(5, 3, 4, _MM_SHUFFLE(0, 3, 0, 0), 0x00FF0000);
-        SET_GATHER_SHUFFLE(5, 3, 4, _MM_SHUFFLE(0, 0, 0, 3), 0x0000FE01);
+        SET_GATHER_SHUFFLE(5, 3, 4, _MM_SHUFFLE(2, 0, 0, 0), 0xFF000000);
         SET_SCATTER_SHUFFLE(5, 4, 0, _MM_SHUFFLE(0, 0, 0, 0), 0x00000000);
         SET_GATHER_SHUFFLE(5, 4, 0, _MM_SHUFFLE(0, 0, 0, 0), 0x00000000);
         SET_SCATTER_SHUFFLE(5, 4, 1, _MM_SHUFFLE(0, 0, 0, 0), 0x000000FF);
-        SET_GATHER_SHUFFLE(5, 4, 1, _MM_SHUFFLE(0, 0, 0, 0), 0x00000000);
+        SET_GATHER_SHUFFLE(5, 4, 1, _MM_SHUFFLE(0, 0, 0, 0), 0x000000FF);
         SET_SCATTER_SHUFFLE(5, 4, 2, _MM_SHUFFLE(0, 0, 1, 0), 0x0000FF00);
-        SET_GATHER_SHUFFLE(5, 4, 2, _MM_SHUFFLE(0, 0, 0, 0), 0x00000000);
+        SET_GATHER_SHUFFLE(5, 4, 2, _MM_SHUFFLE(0, 0, 1, 0), 0x0000FF00);
         SET_SCATTER_SHUFFLE(5, 4, 3, _MM_SHUFFLE(0, 2, 0, 0), 0x00FF0000);
-        SET_GATHER_SHUFFLE(5, 4, 3, _MM_SHUFFLE(0, 0, 0, 0), 0x00000000);
+        SET_GATHER_SHUFFLE(5, 4, 3, _MM_SHUFFLE(0, 2, 0, 0), 0x00FF0000);
         SET_SCATTER_SHUFFLE(5, 4, 4, _MM_SHUFFLE(3, 0, 0, 0), 0xFF000000);
-        SET_GATHER_SHUFFLE(5, 4, 4, _MM_SHUFFLE(0, 0, 0, 0), 0x00000000);
+        SET_GATHER_SHUFFLE(5, 4, 4, _MM_SHUFFLE(3, 0, 0, 0), 0xFF000000);
+
+        template<int GAP, int OFFSET, int LINE>
+        struct scatter_shuffle_pd {};
+        template<int GAP, int OFFSET, int LINE>
+        struct gather_shuffle_pd {};
+
+        SET_SCATTER_SHUFFLE_PD(1, 0, 0, _MM_SHUFFLE2(1, 0), 0xFFFF);
+        SET_GATHER_SHUFFLE_PD(1, 0, 0, _MM_SHUFFLE2(1, 0), 0xFFFF);
+        SET_SCATTER_SHUFFLE_PD(2, 0, 0, _MM_SHUFFLE2(0, 0), 0x00FF);
+        SET_GATHER_SHUFFLE_PD(2, 0, 0, _MM_SHUFFLE2(0, 0), 0x00FF);
+        SET_SCATTER_SHUFFLE_PD(2, 0, 1, _MM_SHUFFLE2(0, 1), 0x00FF);
+        SET_GATHER_SHUFFLE_PD(2, 0, 1, _MM_SHUFFLE2(0, 0), 0xFF00);
+        SET_SCATTER_SHUFFLE_PD(2, 1, 0, _MM_SHUFFLE2(0, 0), 0xFF00);
+        SET_GATHER_SHUFFLE_PD(2, 1, 0, _MM_SHUFFLE2(0, 1), 0x00FF);
+        SET_SCATTER_SHUFFLE_PD(2, 1, 1, _MM_SHUFFLE2(1, 0), 0xFF00);
+        SET_GATHER_SHUFFLE_PD(2, 1, 1, _MM_SHUFFLE2(1, 0), 0xFF00);
+        SET_SCATTER_SHUFFLE_PD(3, 0, 0, _MM_SHUFFLE2(0, 0), 0x00FF);
+        SET_GATHER_SHUFFLE_PD(3, 0, 0, _MM_SHUFFLE2(0, 0), 0x00FF);
+        SET_SCATTER_SHUFFLE_PD(3, 0, 1, _MM_SHUFFLE2(1, 0), 0xFF00);
+        SET_GATHER_SHUFFLE_PD(3, 0, 1, _MM_SHUFFLE2(1, 0), 0xFF00);
+        SET_SCATTER_SHUFFLE_PD(3, 0, 2, _MM_SHUFFLE2(0, 0), 0x0000);
+        SET_GATHER_SHUFFLE_PD(3, 0, 2, _MM_SHUFFLE2(0, 0), 0x0000);
+        SET_SCATTER_SHUFFLE_PD(3, 1, 0, _MM_SHUFFLE2(0, 0), 0xFF00);
+        SET_GATHER_SHUFFLE_PD(3, 1, 0, _MM_SHUFFLE2(0, 1), 0x00FF);
+        SET_SCATTER_SHUFFLE_PD(3, 1, 1, _MM_SHUFFLE2(0, 0), 0x0000);
+        SET_GATHER_SHUFFLE_PD(3, 1, 1, _MM_SHUFFLE2(0, 0), 0x0000);
+        SET_SCATTER_SHUFFLE_PD(3, 1, 2, _MM_SHUFFLE2(0, 1), 0x00FF);
+        SET_GATHER_SHUFFLE_PD(3, 1, 2, _MM_SHUFFLE2(0, 0), 0xFF00);
+        SET_SCATTER_SHUFFLE_PD(3, 2, 0, _MM_SHUFFLE2(0, 0), 0x0000);
+        SET_GATHER_SHUFFLE_PD(3, 2, 0, _MM_SHUFFLE2(0, 0), 0x0000);
+        SET_SCATTER_SHUFFLE_PD(3, 2, 1, _MM_SHUFFLE2(0, 0), 0x00FF);
+        SET_GATHER_SHUFFLE_PD(3, 2, 1, _MM_SHUFFLE2(0, 0), 0x00FF);
+        SET_SCATTER_SHUFFLE_PD(3, 2, 2, _MM_SHUFFLE2(1, 0), 0xFF00);
+        SET_GATHER_SHUFFLE_PD(3, 2, 2, _MM_SHUFFLE2(1, 0), 0xFF00);
+        SET_SCATTER_SHUFFLE_PD(4, 0, 0, _MM_SHUFFLE2(0, 0), 0x00FF);
+        SET_GATHER_SHUFFLE_PD(4, 0, 0, _MM_SHUFFLE2(0, 0), 0x00FF);
+        SET_SCATTER_SHUFFLE_PD(4, 0, 1, _MM_SHUFFLE2(0, 0), 0x0000);
+        SET_GATHER_SHUFFLE_PD(4, 0, 1, _MM_SHUFFLE2(0, 0), 0x0000);
+        SET_SCATTER_SHUFFLE_PD(4, 0, 2, _MM_SHUFFLE2(0, 1), 0x00FF);
+        SET_GATHER_SHUFFLE_PD(4, 0, 2, _MM_SHUFFLE2(0, 0), 0xFF00);
+        SET_SCATTER_SHUFFLE_PD(4, 0, 3, _MM_SHUFFLE2(0, 0), 0x0000);
+        SET_GATHER_SHUFFLE_PD(4, 0, 3, _MM_SHUFFLE2(0, 0), 0x0000);
+        SET_SCATTER_SHUFFLE_PD(4, 1, 0, _MM_SHUFFLE2(0, 0), 0xFF00);
+        SET_GATHER_SHUFFLE_PD(4, 1, 0, _MM_SHUFFLE2(0, 1), 0x00FF);
+        SET_SCATTER_SHUFFLE_PD(4, 1, 1, _MM_SHUFFLE2(0, 0), 0x0000);
+        SET_GATHER_SHUFFLE_PD(4, 1, 1, _MM_SHUFFLE2(0, 0), 0x0000);
+        SET_SCATTER_SHUFFLE_PD(4, 1, 2, _MM_SHUFFLE2(1, 0), 0xFF00);
+        SET_GATHER_SHUFFLE_PD(4, 1, 2, _MM_SHUFFLE2(1, 0), 0xFF00);
+        SET_SCATTER_SHUFFLE_PD(4, 1, 3, _MM_SHUFFLE2(0, 0), 0x0000);
+        SET_GATHER_SHUFFLE_PD(4, 1, 3, _MM_SHUFFLE2(0, 0), 0x0000);
+        SET_SCATTER_SHUFFLE_PD(4, 2, 0, _MM_SHUFFLE2(0, 0), 0x0000);
+        SET_GATHER_SHUFFLE_PD(4, 2, 0, _MM_SHUFFLE2(0, 0), 0x0000);
+        SET_SCATTER_SHUFFLE_PD(4, 2, 1, _MM_SHUFFLE2(0, 0), 0x00FF);
+        SET_GATHER_SHUFFLE_PD(4, 2, 1, _MM_SHUFFLE2(0, 0), 0x00FF);
+        SET_SCATTER_SHUFFLE_PD(4, 2, 2, _MM_SHUFFLE2(0, 0), 0x0000);
+        SET_GATHER_SHUFFLE_PD(4, 2, 2, _MM_SHUFFLE2(0, 0), 0x0000);
+        SET_SCATTER_SHUFFLE_PD(4, 2, 3, _MM_SHUFFLE2(0, 1), 0x00FF);
+        SET_GATHER_SHUFFLE_PD(4, 2, 3, _MM_SHUFFLE2(0, 0), 0xFF00);
+        SET_SCATTER_SHUFFLE_PD(4, 3, 0, _MM_SHUFFLE2(0, 0), 0x0000);
+        SET_GATHER_SHUFFLE_PD(4, 3, 0, _MM_SHUFFLE2(0, 0), 0x0000);
+        SET_SCATTER_SHUFFLE_PD(4, 3, 1, _MM_SHUFFLE2(0, 0), 0xFF00);
+        SET_GATHER_SHUFFLE_PD(4, 3, 1, _MM_SHUFFLE2(0, 1), 0x00FF);
+        SET_SCATTER_SHUFFLE_PD(4, 3, 2, _MM_SHUFFLE2(0, 0), 0x0000);
+        SET_GATHER_SHUFFLE_PD(4, 3, 2, _MM_SHUFFLE2(0, 0), 0x0000);
+        SET_SCATTER_SHUFFLE_PD(4, 3, 3, _MM_SHUFFLE2(1, 0), 0xFF00);
+        SET_GATHER_SHUFFLE_PD(4, 3, 3, _MM_SHUFFLE2(1, 0), 0xFF00);
+
+        // Byte lanes for pshufb, computed instead of tabulated: GAP registers of 16 bytes
+        // interleave 16 elements, component OFFSET of element l is byte l * GAP + OFFSET of
+        // the block. Mask bytes with the top bit set make pshufb write a zero.
+        template<int GAP, int OFFSET, int LINE>
+        struct gather_shuffle_epi8
+        {
+            // Byte of register LINE that lane l of the component comes from
+            static constexpr char at(int l)
+            {
+                return (l * GAP + OFFSET) / 16 == LINE ? (char)((l * GAP + OFFSET) % 16) : (char)0x80;
+            }
+            enum { last = (LINE * 16 + 15 - OFFSET) / GAP < 15 ? (LINE * 16 + 15 - OFFSET) / GAP : 15 };
+            enum { used = last * GAP + OFFSET >= LINE * 16 }; // Register LINE holds lanes of the component
+
+            FORCEINLINE static __m128i shuffle()
+            {
+                return _mm_setr_epi8(at(0), at(1), at(2), at(3), at(4), at(5), at(6), at(7),
+                                     at(8), at(9), at(10), at(11), at(12), at(13), at(14), at(15));
+            }
+        };
+
+        template<int GAP, int OFFSET, int LINE>
+        struct scatter_shuffle_epi8
+        {
+            // Lane of the component that byte b of register LINE takes
+            static constexpr char at(int b)
+            {
+                return (LINE * 16 + b) % GAP == OFFSET ? (char)((LINE * 16 + b) / GAP) : (char)0x80;
+            }
+            enum { used = GAP <= 16 };
+
+            FORCEINLINE static __m128i shuffle()
+            {
+                return _mm_setr_epi8(at(0), at(1), at(2), at(3), at(4), at(5), at(6), at(7),
+                                     at(8), at(9), at(10), at(11), at(12), at(13), at(14), at(15));
+            }
+        };
     }
 }
 
-#undef SET_SCATTER_SHUFFLE
\ No newline at end of file
+#undef SET_SCATTER_SHUFFLE
+#undef SET_GATHER_SHUFFLE
+#undef SET_SCATTER_SHUFFLE_PD
+#undef SET_GATHER_SHUFFLE_PD
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "core.h"
+#include "simd.h"
+
+namespace simd
+{
+    // Organized (row-major, width x height) images where every block also sees its
+    // neighbourhood: the blocks one row up and down and one pixel to the left and right,
+    // already gathered. Rows are gathered once, when they first come into view, into
+    // three planar line buffers that slide down the image with the blocks, so every row
+    // is reused as down, center and up, and left / right are unaligned loads from the
+    // center line. Neighbours past the image border repeat the border pixel. Both layouts
+    // have to be interleaved, and input and output separate.
+    template<typename T1, class D1, typename T2, class D2, engine_type ET = DEFAULT>
+    class stencil_transformation
+    {
+    public:
+        typedef transformation<T1, D1, T2, D2, ET> stream_type;
+        typedef typename stream_type::engine_t engine_t;
+        typedef typename stream_type::input_type input_type;
+        typedef typename stream_type::gather_type gather_type;
+        typedef typename stream_type::output_type output_type;
+        typedef typename stream_type::input_underlying_type input_underlying_type;
+        typedef std::array<gather_type, stream_type::elements_in> gathered_type;
+
+        enum { elements_in = stream_type::elements_in };
+        enum { lanes = stream_type::blocks_gather };
+
+        static_assert((int)stream_type::input_layout::access == (int)INTERLEAVED &&
+                      (int)stream_type::output_layout::access == (int)INTERLEAVED,
+            "Stencils need interleaved input and output!");
+
+        stencil_transformation() : _width(0), _height(0), _columns(0), _first(0), _steps(0) {}
+        stencil_transformation(T1 * input, T2 * output, size_t width, size_t height) { bind(input, output, width, height); }
+
+        void bind(T1 * input, T2 * output, size_t width, size_t height)
+        {
+            assert(width % lanes == 0 && height > 0);
+            assert((const void*)input != (const void*)output);
+
+            _stream.bind(input, output, width * height);
+            _width = width;
+            _height = height;
+            _columns = width / lanes;
+            _first = 0;
+            _steps = _columns * height;
+        }
+
+        size_t width() const { return _width; }
+        size_t height() const { return _height; }
+        size_t size() const { return _width * _height; }
+
+        // Iterator steps, one block each, in row-major order
+        size_t blocks() const { return _steps; }
+
+        stencil_transformation slice(size_t first_block, size_t count) const
+        {
+            assert(first_block + count <= blocks());
+            stencil_transformation result(*this);
+            result._first = _first + first_block;
+            result._steps = count;
+            return result;
+        }
+
+        static bool supported() { return stream_type::supported(); }
+        bool can_split() const { return true; }
+
+        template<class T>
+        void apply(T action)
+        {
+            if (supported())
+            {
+                action(*this);
+            }
+            else
+            {
+                std::cout << "Engine not supported!" << std::endl;
+            }
+        }
+
+        class iterator;
+
+        // What the loop body sees of a step: a handle on the iterator, which owns the lines
+        class neighbourhood
+        {
+        public:
+            FORCEINLINE explicit neighbourhood(iterator* owner) : _owner(owner) {}
+
+            size_t row() const { return _owner->_row; }
+            size_t column() const { return _owner->_column; }
+
+            // Gathered x / y / z... of the block and of its four neighbours
+            FORCEINLINE gathered_type center() const { return _owner->read(_owner->_center, 0); }
+            FORCEINLINE gathered_type up() const { return _owner->read(_owner->_up, 0); }
+            FORCEINLINE gathered_type down() const { return _owner->read(_owner->_down, 0); }
+            FORCEINLINE gathered_type left() const { return _owner->read(_owner->_center, -1); }
+            FORCEINLINE gathered_type right() const { return _owner->read(_owner->_center, 1); }
+
+            template<class T, class... A>
+            output_type scatter(const T& t, const A&... args) const
+            {
+                return _owner->block(_owner->_row, _owner->_column).scatter(t, args...);
+            }
+
+            void store(const output_type& val) { _owner->block(_owner->_row, _owner->_column).store(val); }
+
+        private:
+            iterator* _owner;
+        };
+
+        class iterator
+        {
+        public:
+            FORCEINLINE iterator(stencil_transformation* owner, size_t index, size_t end)
+                : _owner(owner), _index(index), _end(end), _row(index / owner->_columns), _column(index % owner->_columns)
+            {
+                if (_index == _end) return;
+                _pitch = _owner->_width + 2;
+                _lines.resize(3 * elements_in * _pitch);
+                load_rows();
+            }
+            FORCEINLINE iterator& operator++()
+            {
+                if (++_index == _end) return *this;
+                if (++_column == _owner->_columns)
+                {
+                    _column = 0;
+                    ++_row;
+                    slide();
+                }
+                return *this;
+            }
+            FORCEINLINE bool operator==(const iterator& other) const { return _index == other._index; }
+            FORCEINLINE bool operator!=(const iterator& other) const { return !(*this == other); }
+
+            FORCEINLINE neighbourhood operator*() { return neighbourhood(this); }
+
+        private:
+            friend class neighbourhood;
+
+            FORCEINLINE typename stream_type::iterator block(size_t row, size_t column) const
+            {
+                return typename stream_type::iterator(&_owner->_stream, row * _owner->_columns + column);
+            }
+
+            // Component c of a line slot, with one pixel of padding on either side
+            FORCEINLINE T1* line(int slot, int c) { return &_lines[(slot * elements_in + c) * _pitch + 1]; }
+
+            FORCEINLINE gathered_type read(int slot, int offset)
+            {
+                gathered_type result;
+                for (int c = 0; c < elements_in; c++)
+                    result[c] = gather_type(reinterpret_cast<const input_underlying_type*>(line(slot, c) + _column * lanes + offset));
+                return result;
+            }
+
+            // Image row, clamped to the image, gathered into a line slot with the border pixels repeated into the padding
+            void gather_row(ptrdiff_t row, int slot)
+            {
+                if (row < 0) row = 0;
+                if (row >= (ptrdiff_t)_owner->_height) row = _owner->_height - 1;
+                for (size_t column = 0; column < _owner->_columns; column++)
+                {
+                    auto i = block(row, column);
+                    const auto soa = i.gather(i.load());
+                    for (int c = 0; c < elements_in; c++)
+                        soa[c].store(reinterpret_cast<input_underlying_type*>(line(slot, c) + column * lanes));
+                }
+                for (int c = 0; c < elements_in; c++)
+                {
+                    line(slot, c)[-1] = line(slot, c)[0];
+                    line(slot, c)[_owner->_width] = line(slot, c)[_owner->_width - 1];
+                }
+            }
+
+            // First row of the iterator, all three lines from scratch
+            void load_rows()
+            {
+                _up = 0; _center = 1; _down = 2;
+                gather_row((ptrdiff_t)_row - 1, _up);
+                gather_row(_row, _center);
+                gather_row(_row + 1, _down);
+            }
+            // Next row: the lines rotate and only the new bottom one is gathered
+            void slide()
+            {
+                const int top = _up;
+                _up = _center;
+                _center = _down;
+                _down = top;
+                gather_row(_row + 1, _down);
+            }
+
+            stencil_transformation* _owner;
+            size_t _index;
+            size_t _end;
+            size_t _row, _column;
+            size_t _pitch; // Scalars per line component
+            std::vector<T1> _lines;
+            int _up, _center, _down; // Slots of the lines
+        };
+
+        FORCEINLINE iterator begin() { return iterator(this, _first, _first + _steps); }
+        FORCEINLINE iterator end() { return iterator(this, _first + _steps, _first + _steps); }
+
+    private:
+        stream_type _stream;
+        size_t _width;
+        size_t _height;
+        size_t _columns; // Blocks per row
+        size_t _first;   // Step range this object iterates over
+        size_t _steps;
+    };
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <algorithm>
+#include <stdint.h>
+#include <vector>
+
+#include "core.h"
+#include "simd.h"
+
+namespace simd
+{
+    // When a pixel that lost its depth keeps its last filtered value, by how many of the
+    // previous frames it had depth in (same modes as the librealsense temporal filter)
+    enum persistence
+    {
+        PERSIST_NEVER,
+        PERSIST_8_OF_8,
+        PERSIST_2_OF_3,
+        PERSIST_2_OF_4,
+        PERSIST_2_OF_8,
+        PERSIST_1_OF_2,
+        PERSIST_1_OF_5,
+        PERSIST_1_OF_8,
+        PERSIST_ALWAYS,
+    };
+
+    // Exponential moving average over consecutive depth frames. A pixel blends into its
+    // history with weight alpha while it moves by less than delta, and restarts from the
+    // new depth on a larger jump. Pixels without depth (0) keep the last filtered value
+    // if the persistence mode accepts their validity over the previous 8 frames. The
+    // filtered frame and one byte of validity bits per pixel carry over from one apply()
+    // to the next. Every decision is a lane mask, there are no per-pixel branches.
+    template<engine_type ET = DEFAULT>
+    class temporal_filter
+    {
+    public:
+        typedef engine<ET> engine_t;
+        typedef vector<engine_t, float, 1> vector_t;
+        typedef typename vector_t::underlying_t underlying_t;
+        typedef broadcast<engine_t, float> broadcast_t;
+
+        enum { lanes = vector_t::lanes_per_register };
+
+        temporal_filter(size_t count, float alpha = 0.4f, float delta = 0.02f, persistence mode = PERSIST_2_OF_3)
+            : _count(count), _alpha(alpha), _delta(delta), _last(count), _history(count)
+        {
+            assert(count % lanes == 0);
+            for (unsigned int h = 0; h < 256; h++)
+                _persist[h] = persists(mode, h) ? 1 : 0;
+        }
+
+        // Forget all previous frames
+        void reset()
+        {
+            std::fill(_last.begin(), _last.end(), 0.f);
+            std::fill(_history.begin(), _history.end(), (uint8_t)0);
+        }
+
+        static bool supported()
+        {
+            static const bool result = engine_t::can_run();
+            return result;
+        }
+
+        // One frame of count depth values, output may be the depth buffer itself
+        void apply(const float* depth, float* output)
+        {
+            if (!supported())
+            {
+                std::cout << "Engine not supported!" << std::endl;
+                return;
+            }
+
+            const broadcast_t alpha(_alpha), delta(_delta), zero(0.f);
+            const vector_t none;
+            float* last = _last.data();
+            uint8_t* history = _history.data();
+
+            for (size_t i = 0; i < _count; i += lanes)
+            {
+                vector_t current(reinterpret_cast<const underlying_t*>(depth + i));
+                vector_t previous(reinterpret_cast<const underlying_t*>(last + i));
+                const auto valid = current.greater(zero);
+                const auto had_depth = previous.greater(zero);
+
+                // Persistence is decided by the history before this frame, then this
+                // frame's validity is shifted in
+                const auto valid_bits = valid.bits();
+                unsigned int keep_bits = 0;
+                for (int l = 0; l < lanes; l++)
+                {
+                    const uint8_t h = history[i + l];
+                    keep_bits |= (unsigned int)_persist[h] << l;
+                    history[i + l] = (uint8_t)((h << 1) | ((valid_bits >> l) & 1));
+                }
+                const auto keep = vector_t::from_bits(keep_bits);
+
+                auto step = current - previous;
+                auto back = previous - current;
+                const auto close = vector_t::select(had_depth, vector_t::max(step, back).less(delta), none);
+                // Rounded after the multiply as on every engine, multiply_add would fuse on AVX only
+                const auto smooth = step * alpha + previous;
+
+                const auto result = vector_t::select(valid, vector_t::select(close, smooth, current),
+                                                     vector_t::select(keep, previous, none));
+                result.store(reinterpret_cast<underlying_t*>(output + i));
+                result.store(reinterpret_cast<underlying_t*>(last + i));
+            }
+        }
+
+        // history has bit 0 set if the pixel had depth one frame ago, bit 1 two frames ago...
+        static bool persists(persistence mode, unsigned int history)
+        {
+            switch (mode)
+            {
+            case PERSIST_8_OF_8: return valid_frames(history, 8) == 8;
+            case PERSIST_2_OF_3: return valid_frames(history, 3) >= 2;
+            case PERSIST_2_OF_4: return valid_frames(history, 4) >= 2;
+            case PERSIST_2_OF_8: return valid_frames(history, 8) >= 2;
+            case PERSIST_1_OF_2: return valid_frames(history, 2) >= 1;
+            case PERSIST_1_OF_5: return valid_frames(history, 5) >= 1;
+            case PERSIST_1_OF_8: return valid_frames(history, 8) >= 1;
+            case PERSIST_ALWAYS: return true;
+            default: return false;
+            }
+        }
+
+    private:
+        static int valid_frames(unsigned int history, int frames)
+        {
+            int result = 0;
+            for (int f = 0; f < frames; f++)
+                result += (history >> f) & 1;
+            return result;
+        }
+
+        size_t _count;
+        float _alpha, _delta;
+        std::vector<float> _last;     // Filtered depth of the previous frame
+        std::vector<uint8_t> _history; // Validity over the previous 8 frames, one byte per pixel
+        uint8_t _persist[256];         // persists() for every history byte of the mode
+    };
+}
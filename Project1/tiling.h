@@ -0,0 +1,222 @@
+#pragma once
+
+#include <fstream>
+#include <tuple>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "core.h"
+#include "simd.h"
+
+namespace simd
+{
+    // Size in bytes of the level 1 (data) or level 2 cache of the first core,
+    // or a conservative guess when the platform does not say
+    inline size_t cache_size(int level)
+    {
+        const size_t fallback = level == 1 ? 32 * 1024 : 256 * 1024;
+#ifdef _WIN32
+        DWORD length = 0;
+        GetLogicalProcessorInformation(nullptr, &length);
+        std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> info(length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+        if (info.empty() || !GetLogicalProcessorInformation(info.data(), &length)) return fallback;
+        for (auto&& i : info)
+        {
+            if (i.Relationship == RelationCache && i.Cache.Level == level &&
+                (i.Cache.Type == CacheData || i.Cache.Type == CacheUnified))
+                return i.Cache.Size;
+        }
+        return fallback;
+#else
+        long result = -1;
+#if defined(_SC_LEVEL1_DCACHE_SIZE) && defined(_SC_LEVEL2_CACHE_SIZE)
+        result = sysconf(level == 1 ? _SC_LEVEL1_DCACHE_SIZE : _SC_LEVEL2_CACHE_SIZE);
+#endif
+        if (result > 0) return (size_t)result;
+
+        // sysfs lists index0 / index1 as L1 data / instruction and index2 as L2
+        std::ifstream file(level == 1 ? "/sys/devices/system/cpu/cpu0/cache/index0/size"
+                                      : "/sys/devices/system/cpu/cpu0/cache/index2/size");
+        size_t size = 0;
+        char unit = 0;
+        if (file >> size >> unit && size)
+            return unit == 'K' ? size * 1024 : unit == 'M' ? size * 1024 * 1024 : size;
+        return fallback;
+#endif
+    }
+
+    // One step of a tiled_chain: a transformation and the action run over it
+    template<class TR, class A>
+    struct tile_stage
+    {
+        typedef TR transformation_type;
+        typedef typename TR::input_element input_element;
+        typedef typename TR::output_element output_element;
+
+        static_assert((int)TR::input_layout::access != (int)PLANAR && (int)TR::output_layout::access == (int)INTERLEAVED,
+            "Tiled stages need layouts that can be cut into contiguous tiles!");
+
+        TR transformation;
+        A action;
+    };
+
+    template<class TR, class A>
+    tile_stage<TR, A> make_stage(A action)
+    {
+        tile_stage<TR, A> result;
+        result.action = action;
+        return result;
+    }
+
+    template<class... S>
+    struct chain_bytes;
+    template<class S>
+    struct chain_bytes<S>
+    {
+        enum { intermediate = sizeof(typename S::output_element) };
+        enum { scratch = 0 };
+    };
+    template<class S, class... R>
+    struct chain_bytes<S, R...>
+    {
+        enum { intermediate = sizeof(typename S::output_element) + chain_bytes<R...>::intermediate };
+        enum { scratch = sizeof(typename S::output_element) > (size_t)chain_bytes<R...>::scratch
+                         ? sizeof(typename S::output_element) : (size_t)chain_bytes<R...>::scratch };
+    };
+
+    // Runs a chain of transformations (i.e. deproject -> extrinsics -> project) tile by
+    // tile instead of pass by pass. Results of one stage go to a tile-sized scratch buffer,
+    // sized to stay in cache for the next stage to read back. Stages are re-bound to every
+    // tile, so their layouts have to be contiguous per element: interleaved, or strided
+    // input. A runtime stride set on a stage's transformation is kept across tiles.
+    template<class... S>
+    class tiled_chain
+    {
+    public:
+        enum { stages = sizeof...(S) };
+
+        typedef typename std::tuple_element<0, std::tuple<S...>>::type first_stage;
+        typedef typename std::tuple_element<stages - 1, std::tuple<S...>>::type last_stage;
+        typedef typename first_stage::transformation_type::input_scalar input_scalar;
+        typedef typename last_stage::transformation_type::output_scalar output_scalar;
+
+        // Bytes a single element occupies across the input, every intermediate and the output
+        enum { bytes_per_element = sizeof(typename first_stage::input_element) + chain_bytes<S...>::intermediate };
+
+        explicit tiled_chain(S... stages) : _stages(stages...) { set_tile(default_tile()); }
+
+        // Elements per tile, rounded down to whole SIMD blocks of every stage
+        void set_tile(size_t tile)
+        {
+            _tile = tile - tile % granularity;
+            if (!_tile) _tile = granularity;
+            for (auto&& s : _scratch) s.resize(_tile * chain_bytes<S...>::scratch);
+        }
+        size_t tile() const { return _tile; }
+
+        // All the data of a tile takes half of L2
+        static size_t default_tile() { return cache_size(2) / 2 / bytes_per_element; }
+
+        static bool supported() { return all_supported<0>(); }
+
+        // count has to suit every stage, as it would for stand-alone transformations
+        void apply(const input_scalar* input, output_scalar* output, size_t count)
+        {
+            if (!supported())
+            {
+                std::cout << "Engine not supported!" << std::endl;
+                return;
+            }
+            for (size_t first = 0; first < count; first += _tile)
+            {
+                const auto n = count - first < _tile ? count - first : _tile;
+                run_stage<0>(input + first * input_stride(), output + first * output_elements(), n);
+            }
+        }
+
+        // The same chain, every stage over the whole frame before the next one starts,
+        // through full-frame intermediates. For comparison.
+        void apply_by_pass(const input_scalar* input, output_scalar* output, size_t count)
+        {
+            if (!supported())
+            {
+                std::cout << "Engine not supported!" << std::endl;
+                return;
+            }
+            for (auto&& s : _frames) s.resize(count * chain_bytes<S...>::scratch);
+            run_pass<0>(input, output, count);
+        }
+
+    private:
+        size_t input_stride() const { return std::get<0>(_stages).transformation.input_stride() / sizeof(input_scalar); }
+        static size_t output_elements() { return last_stage::transformation_type::elements_out; }
+
+        enum { granularity = 64 };
+
+        template<int I>
+        static typename std::enable_if<I == sizeof...(S), bool>::type all_supported() { return true; }
+        template<int I>
+        static typename std::enable_if<I < sizeof...(S), bool>::type all_supported()
+        {
+            return std::tuple_element<I, std::tuple<S...>>::type::transformation_type::supported() && all_supported<I + 1>();
+        }
+
+        template<int I, class SRC, class DST>
+        FORCEINLINE void run(const SRC* src, DST* dst, size_t count)
+        {
+            typedef typename std::tuple_element<I, std::tuple<S...>>::type stage_type;
+            typedef typename stage_type::transformation_type::input_scalar T1;
+            typedef typename stage_type::transformation_type::output_scalar T2;
+
+            auto& stage = std::get<I>(_stages);
+            stage.transformation.bind(const_cast<T1*>(reinterpret_cast<const T1*>(src)), reinterpret_cast<T2*>(dst), count);
+            stage.action(stage.transformation);
+        }
+
+        // Stage I of a tile writes scratch[I % 2], which stage I + 1 reads back
+        template<int I, class SRC>
+        typename std::enable_if<I == sizeof...(S) - 1>::type run_stage(const SRC* src, output_scalar* output, size_t count)
+        {
+            run<I>(src, output, count);
+        }
+        template<int I, class SRC>
+        typename std::enable_if<I < sizeof...(S) - 1>::type run_stage(const SRC* src, output_scalar* output, size_t count)
+        {
+            char* dst = _scratch[I % 2].data();
+            run<I>(src, dst, count);
+            run_stage<I + 1>(dst, output, count);
+        }
+
+        template<int I, class SRC>
+        typename std::enable_if<I == sizeof...(S) - 1>::type run_pass(const SRC* src, output_scalar* output, size_t count)
+        {
+            run<I>(src, output, count);
+        }
+        template<int I, class SRC>
+        typename std::enable_if<I < sizeof...(S) - 1>::type run_pass(const SRC* src, output_scalar* output, size_t count)
+        {
+            char* dst = _frames[I % 2].data();
+            run<I>(src, dst, count);
+            run_pass<I + 1>(dst, output, count);
+        }
+
+        std::tuple<S...> _stages;
+        size_t _tile;
+        std::vector<char> _scratch[2];
+        std::vector<char> _frames[2];
+    };
+
+    template<class... S>
+    tiled_chain<S...> make_tiled_chain(S... stages)
+    {
+        return tiled_chain<S...>(stages...);
+    }
+}
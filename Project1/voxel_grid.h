@@ -0,0 +1,431 @@
+#pragma once
+
+#include <stdint.h>
+#include <thread>
+#include <vector>
+#include <emmintrin.h>
+
+#include "core.h"
+#include "simd.h"
+
+namespace simd
+{
+    // Voxel-grid downsampling: points are quantized to voxel keys and every occupied
+    // voxel keeps the running sum of its points, for one centroid per voxel. Voxels
+    // live in an open-addressing table of cache-line buckets, 8 keys per 64 bytes,
+    // probed bucket by bucket, with the sums in a parallel array. A grid can be
+    // limited to one partition of the key space (a range of key hashes), so that
+    // partitions split the voxels between threads without sharing any. A staging
+    // grid sums nothing: it sorts the points it is fed by partition, in order, for
+    // the partition grids to pick up.
+    template<typename E, typename T = float>
+    class voxel_grid
+    {
+    public:
+        enum { lanes = simd::lanes<E, T>::count };
+        enum { bucket_keys = 8 };
+        enum { axis_bits = 21 }; // Per axis, +-2^20 voxels around the origin
+
+        voxel_grid(T voxel_size = T(1), unsigned int partition = 0, unsigned int partitions = 1)
+            : _voxel_size(voxel_size), _partition(partition), _partitions(partitions), _size(0)
+        {
+            assert(voxel_size > 0 && partition < partitions);
+            allocate(64);
+        }
+
+        T voxel_size() const { return _voxel_size; }
+        size_t size() const { return _size; }
+
+        // Empties the grid, keeping the table it grew into for the next frame
+        void clear()
+        {
+            _size = 0;
+            allocate(_buckets);
+            for (auto&& s : _staged) s.clear();
+        }
+
+        // Makes this a staging grid for the given number of partitions: points added
+        // from now on are only quantized and kept, with their key, per partition
+        void stage(unsigned int partitions)
+        {
+            assert(partitions > 0 && !_size);
+            _staged.assign(partitions, std::vector<staged_point>());
+        }
+
+        // Sums the points a staging grid kept for this grid's partition, in the order
+        // they were added
+        void add_staged(const voxel_grid& stage)
+        {
+            assert(stage._voxel_size == _voxel_size && stage._staged.size() == _partitions);
+            for (auto&& p : stage._staged[_partition])
+                accumulate(p.key, hash(p.key), p.x, p.y, p.z);
+        }
+
+        // Voxel of a point, the reference for the quantizer: floor(p / size) per axis,
+        // clamped, biased to unsigned and packed x | y << 21 | z << 42
+        static uint64_t key(T x, T y, T z, T inverse_size)
+        {
+            return pack(clamp(x * inverse_size), clamp(y * inverse_size), clamp(z * inverse_size));
+        }
+
+        // Quantization with pre-broadcast constants, meant to live on the stack of the
+        // loop that feeds it. Scaling and clamping happen in registers, the lanes are
+        // then packed into keys and hashed as a batch, and their buckets prefetched
+        // before any of them is probed.
+        class quantizer
+        {
+        public:
+            explicit quantizer(voxel_grid& owner)
+                : _owner(owner), _inverse(T(1) / owner._voxel_size),
+                  _low(T(-(1 << (axis_bits - 1)))), _high(T((1 << (axis_bits - 1)) - 1))
+            {}
+
+            template<int K>
+            FORCEINLINE void add(const vector<E, T, K>& x, const vector<E, T, K>& y, const vector<E, T, K>& z)
+            {
+                add(x, y, z, 0xFFFFFFFFu);
+            }
+
+            // Only lanes set in mask are added, i.e. points with depth
+            template<int K>
+            FORCEINLINE void add(const vector<E, T, K>& x, const vector<E, T, K>& y, const vector<E, T, K>& z,
+                                 const vector<E, T, K>& mask)
+            {
+                add(x, y, z, mask.bits());
+            }
+
+        private:
+            template<int K>
+            FORCEINLINE void add(const vector<E, T, K>& x, const vector<E, T, K>& y, const vector<E, T, K>& z, unsigned int bits)
+            {
+                const auto qx = scale(x), qy = scale(y), qz = scale(z);
+                const bool staging = !_owner._staged.empty();
+
+                T px[lanes], py[lanes], pz[lanes], vx[lanes], vy[lanes], vz[lanes];
+                for (int i = 0; i < K; i++, bits >>= lanes)
+                {
+                    simd::lanes<E, T>::extract(qx.fetch(i), px);
+                    simd::lanes<E, T>::extract(qy.fetch(i), py);
+                    simd::lanes<E, T>::extract(qz.fetch(i), pz);
+                    simd::lanes<E, T>::extract(x.fetch(i), vx);
+                    simd::lanes<E, T>::extract(y.fetch(i), vy);
+                    simd::lanes<E, T>::extract(z.fetch(i), vz);
+
+                    // Runs of lanes in one voxel are hashed once
+                    uint64_t keys[lanes];
+                    uint64_t hashes[lanes];
+                    bool owned = false;
+                    for (int lane = 0; lane < lanes; lane++)
+                    {
+                        keys[lane] = pack(px[lane], py[lane], pz[lane]);
+                        if (!lane || keys[lane] != keys[lane - 1])
+                        {
+                            hashes[lane] = hash(keys[lane]);
+                            owned = staging || _owner.owns(hashes[lane]);
+                            if (owned && !staging) _owner.prefetch(hashes[lane]);
+                        }
+                        else hashes[lane] = hashes[lane - 1];
+                        if (!owned) bits &= ~(1u << lane);
+                    }
+                    for (int lane = 0; lane < lanes; lane++)
+                    {
+                        if (!(bits & (1u << lane))) continue;
+                        if (staging) _owner.keep(keys[lane], hashes[lane], vx[lane], vy[lane], vz[lane]);
+                        else _owner.accumulate(keys[lane], hashes[lane], vx[lane], vy[lane], vz[lane]);
+                    }
+                }
+            }
+
+            template<int K>
+            FORCEINLINE vector<E, T, K> scale(const vector<E, T, K>& v) const
+            {
+                vector<E, T, K> low, high;
+                for (int i = 0; i < K; i++)
+                {
+                    low.assign(i, _low.value());
+                    high.assign(i, _high.value());
+                }
+                return vector<E, T, K>::min(vector<E, T, K>::max(v * _inverse, low), high);
+            }
+
+            voxel_grid& _owner;
+            broadcast<E, T> _inverse;
+            broadcast<E, T> _low, _high;
+        };
+
+        quantizer make_quantizer() { return quantizer(*this); }
+
+        // Sums of other added to the voxels of this grid. Grids of different partitions
+        // never share voxels, so merging them only appends.
+        void merge(const voxel_grid& other)
+        {
+            assert(other._voxel_size == _voxel_size);
+            for (size_t s = 0; s < other._cells.size(); s++)
+            {
+                if (other.keys()[s] == empty()) continue;
+                const auto& c = other._cells[s];
+                cell& target = find(other.keys()[s], hash(other.keys()[s]));
+                target.x += c.x; target.y += c.y; target.z += c.z;
+                target.count += c.count;
+            }
+        }
+
+        // size() centroids as interleaved x, y, z, in table order, and optionally the
+        // number of points behind each
+        void centroids(T* xyz, unsigned int* counts = nullptr) const
+        {
+            for (size_t s = 0; s < _cells.size(); s++)
+            {
+                if (keys()[s] == empty()) continue;
+                const auto& c = _cells[s];
+                *xyz++ = c.x / c.count;
+                *xyz++ = c.y / c.count;
+                *xyz++ = c.z / c.count;
+                if (counts) *counts++ = c.count;
+            }
+        }
+
+    private:
+        struct cell
+        {
+            T x, y, z;
+            unsigned int count;
+        };
+
+        struct staged_point
+        {
+            uint64_t key;
+            T x, y, z;
+        };
+
+        static uint64_t empty() { return ~0ull; } // Keys use 63 bits
+
+        static T clamp(T q)
+        {
+            const T low = T(-(1 << (axis_bits - 1))), high = T((1 << (axis_bits - 1)) - 1);
+            return q < low ? low : q > high ? high : (q == q ? q : low);
+        }
+        static uint64_t pack(T qx, T qy, T qz)
+        {
+            const int bias = 1 << (axis_bits - 1);
+            return (uint64_t)(floor(qx) + bias) |
+                   ((uint64_t)(floor(qy) + bias) << axis_bits) |
+                   ((uint64_t)(floor(qz) + bias) << (2 * axis_bits));
+        }
+        // floor() of a clamped coordinate, without the library call std::floor is before SSE4.1
+        static int floor(T q)
+        {
+            const int t = (int)q;
+            return t - (q < T(t));
+        }
+        // 64-bit finalizer of MurmurHash3, every key bit reaches the bucket and partition bits
+        static uint64_t hash(uint64_t key)
+        {
+            key ^= key >> 33;
+            key *= 0xff51afd7ed558ccdull;
+            key ^= key >> 33;
+            key *= 0xc4ceb9fe1a85ec53ull;
+            key ^= key >> 33;
+            return key;
+        }
+
+        // Partitions split the upper 32 bits of the hash into equal ranges, buckets take the lower ones
+        static unsigned int partition_of(uint64_t h, unsigned int partitions)
+        {
+            return (unsigned int)(((h >> 32) * partitions) >> 32);
+        }
+        bool owns(uint64_t h) const
+        {
+            return _partitions == 1 || partition_of(h, _partitions) == _partition;
+        }
+        size_t bucket_of(uint64_t h) const { return (size_t)h & (_buckets - 1); }
+
+        void prefetch(uint64_t h) const
+        {
+            _mm_prefetch((const char*)(keys() + bucket_of(h) * bucket_keys), _MM_HINT_T0);
+        }
+
+        FORCEINLINE void keep(uint64_t key, uint64_t h, T x, T y, T z)
+        {
+            const staged_point p = { key, x, y, z };
+            _staged[partition_of(h, (unsigned int)_staged.size())].push_back(p);
+        }
+
+        // Neighbouring points mostly share a voxel, so the last one is kept at hand
+        FORCEINLINE void accumulate(uint64_t key, uint64_t h, T x, T y, T z)
+        {
+            if (key != _last_key)
+            {
+                // find() may grow the table, so _cells.data() is only read after it
+                cell& c = find(key, h);
+                _last_slot = &c - _cells.data();
+                _last_key = key;
+            }
+            cell& c = _cells[_last_slot];
+            c.x += x; c.y += y; c.z += z;
+            c.count++;
+        }
+
+        // Cell of key, inserted empty if the key is new. Probes the key's bucket, then the
+        // next ones. Keys are never removed, so a bucket fills front to back and its first
+        // free slot ends the search.
+        FORCEINLINE cell& find(uint64_t key, uint64_t h)
+        {
+            for (size_t b = bucket_of(h);; b = (b + 1) & (_buckets - 1))
+            {
+                uint64_t* bucket = keys() + b * bucket_keys;
+                unsigned int hit, free;
+                match(bucket, key, hit, free);
+                if (hit) return _cells[b * bucket_keys + lowest_bit(hit)];
+                if (free)
+                {
+                    if ((_size + 1) * 4 > _cells.size() * 3)
+                    {
+                        // Rehashed, probe again from the key's bucket of the larger table
+                        grow();
+                        b = (bucket_of(h) - 1) & (_buckets - 1);
+                        continue;
+                    }
+                    const int s = lowest_bit(free);
+                    bucket[s] = key;
+                    _size++;
+                    cell& c = _cells[b * bucket_keys + s];
+                    c.x = c.y = c.z = T(0);
+                    c.count = 0;
+                    return c;
+                }
+            }
+        }
+
+        // One bit per slot of the bucket that holds key / is free, compared two keys to a
+        // register. 64-bit compares are SSE4.1, so both 32-bit halves have to match.
+        FORCEINLINE static void match(const uint64_t* bucket, uint64_t key, unsigned int& hit, unsigned int& free)
+        {
+            const __m128i k = _mm_set1_epi64x((long long)key);
+            const __m128i e = _mm_set1_epi32(-1);
+            hit = free = 0;
+            for (int s = 0; s < bucket_keys; s += 2)
+            {
+                const __m128i v = _mm_loadu_si128((const __m128i*)(bucket + s));
+                __m128i a = _mm_cmpeq_epi32(v, k);
+                __m128i b = _mm_cmpeq_epi32(v, e);
+                a = _mm_and_si128(a, _mm_shuffle_epi32(a, _MM_SHUFFLE(2, 3, 0, 1)));
+                b = _mm_and_si128(b, _mm_shuffle_epi32(b, _MM_SHUFFLE(2, 3, 0, 1)));
+                hit |= (unsigned int)_mm_movemask_pd(_mm_castsi128_pd(a)) << s;
+                free |= (unsigned int)_mm_movemask_pd(_mm_castsi128_pd(b)) << s;
+            }
+        }
+        static int lowest_bit(unsigned int x)
+        {
+            int result = 0;
+            while (!(x & 1)) { x >>= 1; result++; }
+            return result;
+        }
+
+        // Buckets of 64 bytes, from a 64-byte boundary of the key storage on. A copied
+        // grid keeps the offset, so its buckets may straddle cache lines and match()
+        // loads them unaligned; it is only slower if its storage lands elsewhere.
+        uint64_t* keys() { return _key_storage.data() + _key_offset; }
+        const uint64_t* keys() const { return _key_storage.data() + _key_offset; }
+
+        void allocate(size_t buckets)
+        {
+            _buckets = buckets;
+            _key_storage.assign(buckets * bucket_keys + bucket_keys, empty());
+            _key_offset = 0;
+            while ((size_t)(_key_storage.data() + _key_offset) % 64) _key_offset++;
+            _cells.assign(buckets * bucket_keys, cell());
+            _last_key = empty();
+            _last_slot = 0;
+        }
+
+        // Twice the buckets, at most 3 / 4 full
+        void grow()
+        {
+            const std::vector<uint64_t> old_keys(keys(), keys() + _cells.size());
+            const std::vector<cell> cells(_cells);
+            allocate(_buckets * 2);
+            _size = 0;
+            for (size_t s = 0; s < cells.size(); s++)
+            {
+                if (old_keys[s] == empty()) continue;
+                find(old_keys[s], hash(old_keys[s])) = cells[s];
+            }
+        }
+
+        T _voxel_size;
+        unsigned int _partition, _partitions;
+        size_t _size;    // Occupied voxels
+        size_t _buckets; // Power of two
+        std::vector<uint64_t> _key_storage; // empty() marks a free slot
+        size_t _key_offset;
+        uint64_t _last_key; // Last voxel accumulated into and its slot
+        size_t _last_slot;
+        std::vector<cell> _cells;
+        std::vector<std::vector<staged_point>> _staged; // Per partition, staging grids only
+    };
+
+    // Voxel-grid downsampling on threads, in two rounds. First every worker runs
+    // work(slice, grid) over its own range of blocks, with a staging grid that only
+    // quantizes and sorts the points by key hash range. Then every worker sums one
+    // partition of the voxels from all stages, in block order, so no voxel is touched
+    // by two threads and each is summed in point order. The partitions are merged
+    // into one grid.
+    // Against one std::unordered_map pass the table wins with many voxels (tens of
+    // thousands, i.e. 0.01 m over a VGA frame), where the map's node allocations and
+    // cache misses dominate. With a few thousand voxels (0.05 m) the map stays in
+    // cache and beats the table on one thread. Staging writes and reads every point
+    // once more, which threads only win back on cores of their own.
+    template<class TR, class F>
+    voxel_grid<typename TR::engine_t> parallel_voxelize(TR& t, float voxel_size, F work,
+                                                        unsigned int threads = std::thread::hardware_concurrency())
+    {
+        typedef voxel_grid<typename TR::engine_t> grid_type;
+        if (!threads) threads = 1;
+        const auto blocks = t.blocks();
+        if (threads > blocks) threads = blocks ? (unsigned int)blocks : 1;
+
+        grid_type result(voxel_size);
+        if (!TR::supported())
+        {
+            std::cout << "Engine not supported!" << std::endl;
+            return result;
+        }
+
+        std::vector<grid_type> stages(threads, grid_type(voxel_size));
+        std::vector<grid_type> grids;
+        for (unsigned int i = 0; i < threads; i++)
+        {
+            stages[i].stage(threads);
+            grids.push_back(grid_type(voxel_size, i, threads));
+        }
+
+        std::vector<std::thread> workers;
+        size_t first = 0;
+        for (unsigned int i = 0; i < threads; i++)
+        {
+            const auto count = blocks / threads + (i < blocks % threads ? 1 : 0);
+            auto slice = t.slice(first, count);
+            first += count;
+
+            workers.emplace_back([slice, &work, &stages, i]() mutable
+            {
+                work(slice, stages[i]);
+            });
+        }
+        for (auto&& w : workers) w.join();
+
+        workers.clear();
+        for (unsigned int i = 0; i < threads; i++)
+        {
+            workers.emplace_back([&stages, &grids, i]()
+            {
+                for (auto&& s : stages) grids[i].add_staged(s);
+            });
+        }
+        for (auto&& w : workers) w.join();
+
+        for (auto&& g : grids) result.merge(g);
+        return result;
+    }
+}
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <tuple>
+
+#include "core.h"
+#include "simd.h"
+
+namespace simd
+{
+    // One input stream of a zip_transformation: scalar type and layout
+    template<typename T, class D>
+    struct stream
+    {
+        typedef T scalar_type;
+        typedef T storage_type;
+        typedef D layout_type;
+
+        static T* bound(T* input) { return input; }
+        template<class IT>
+        FORCEINLINE static auto load(IT& it, const T*) -> decltype(it.load()) { return it.load(); }
+    };
+
+    // Input stream of 16-bit values encoded as F (depth16, unorm16, fp16, bf16), decoded
+    // into float lanes as it is loaded, i.e. raw depth or infrared next to float points.
+    // Its float transformation only supplies the offsets, the data comes from the buffer.
+    template<class F, class D>
+    struct encoded_stream
+    {
+        typedef float scalar_type;
+        typedef uint16_t storage_type;
+        typedef D layout_type;
+
+        static float* bound(uint16_t*) { return nullptr; }
+        template<class IT>
+        FORCEINLINE static auto load(IT& it, const uint16_t* source) -> decltype(it.load()) { return it.load(source, F()); }
+    };
+
+    template<class... P>
+    struct same_lanes;
+    template<class P>
+    struct same_lanes<P>
+    {
+        enum { lanes = P::blocks_gather, value = 1 };
+    };
+    template<class P, class... R>
+    struct same_lanes<P, R...>
+    {
+        enum { lanes = P::blocks_gather, value = (int)P::blocks_gather == (int)same_lanes<R...>::lanes && same_lanes<R...>::value };
+    };
+
+    // Several input streams advanced in lockstep into one output, i.e. points + normals,
+    // or depth + infrared, in a single pass. Every stream keeps its own element type and
+    // layout, and is loaded and gathered on its own through load<I>() / gather<I>().
+    // All streams must fill a register with the same number of elements, so 16-bit
+    // streams come in as encoded_stream and are widened to float on load.
+    template<typename T2, class D2, engine_type ET, class... S>
+    class zip_transformation
+    {
+    public:
+        typedef std::tuple<transformation<typename S::scalar_type, typename S::layout_type, T2, D2, ET>...> parts_type;
+        typedef typename std::tuple_element<0, parts_type>::type output_part;
+        typedef typename output_part::engine_t engine_t;
+        typedef typename output_part::output_type output_type;
+
+        template<int I>
+        struct part
+        {
+            typedef typename std::tuple_element<I, std::tuple<S...>>::type stream_type;
+            typedef typename std::tuple_element<I, parts_type>::type type;
+            typedef typename type::input_type input_type;
+            typedef typename type::gather_type gather_type;
+            typedef std::array<gather_type, type::elements_in> gathered_type;
+        };
+
+        enum { inputs = sizeof...(S) };
+
+        static_assert(same_lanes<transformation<typename S::scalar_type, typename S::layout_type, T2, D2, ET>...>::value,
+            "Zipped streams must fit the same number of elements per register!");
+
+        zip_transformation() {}
+        zip_transformation(T2 * output, size_t count, typename S::storage_type*... input) { bind(output, count, input...); }
+
+        void bind(T2 * output, size_t count, typename S::storage_type*... input)
+        {
+            bind_parts<0>(output, count, input...);
+        }
+
+        size_t size() const { return std::get<0>(_parts).size(); }
+        size_t blocks() const { return std::get<0>(_parts).blocks(); }
+
+        zip_transformation slice(size_t first_block, size_t count) const
+        {
+            zip_transformation result(*this);
+            result.slice_parts<0>(first_block, count);
+            return result;
+        }
+
+        static bool supported() { return output_part::supported(); }
+        bool can_split() const { return can_split_parts<0>(); }
+
+        template<class T>
+        void apply(T action)
+        {
+            if (supported())
+            {
+                action(*this);
+            }
+            else
+            {
+                std::cout << "Engine not supported!" << std::endl;
+            }
+        }
+
+        class iterator
+        {
+        public:
+            FORCEINLINE iterator(zip_transformation* owner, size_t index) : _owner(owner), _index(index) {}
+            FORCEINLINE iterator& operator++() { ++_index; return *this; }
+            FORCEINLINE bool operator==(const iterator& other) const { return _index == other._index; }
+            FORCEINLINE bool operator!=(const iterator& other) const { return !(*this == other); }
+
+            FORCEINLINE iterator operator*() { return *this; }
+
+            template<int I>
+            typename part<I>::input_type load()
+            {
+                auto it = part_iterator<I>();
+                return part<I>::stream_type::load(it, std::get<I>(_owner->_sources));
+            }
+
+            template<int I>
+            typename part<I>::gathered_type gather(const typename part<I>::input_type& block) const
+            {
+                return part_iterator<I>().gather(block);
+            }
+
+            // load<I>() and gather<I>() in one go
+            template<int I>
+            typename part<I>::gathered_type fetch() { return gather<I>(load<I>()); }
+
+            template<class T, class... A>
+            output_type scatter(const T& t, const A&... args) const
+            {
+                return part_iterator<0>().scatter(t, args...);
+            }
+
+            void store(const output_type& val) { part_iterator<0>().store(val); }
+
+        private:
+            template<int I>
+            FORCEINLINE typename part<I>::type::iterator part_iterator() const
+            {
+                return typename part<I>::type::iterator(&std::get<I>(_owner->_parts), _index);
+            }
+
+            zip_transformation* _owner;
+            size_t _index;
+        };
+
+        FORCEINLINE iterator begin() { return iterator(this, std::get<0>(_parts).first_block()); }
+        FORCEINLINE iterator end() { return iterator(this, std::get<0>(_parts).first_block() + blocks()); }
+
+    private:
+        template<int I>
+        void bind_parts(T2 * output, size_t count) {}
+        template<int I, class P, class... R>
+        void bind_parts(T2 * output, size_t count, P* input, R*... rest)
+        {
+            std::get<I>(_parts).bind(part<I>::stream_type::bound(input), output, count);
+            std::get<I>(_sources) = input;
+            bind_parts<I + 1>(output, count, rest...);
+        }
+
+        template<int I>
+        typename std::enable_if<I == sizeof...(S)>::type slice_parts(size_t first_block, size_t count) {}
+        template<int I>
+        typename std::enable_if<I < sizeof...(S)>::type slice_parts(size_t first_block, size_t count)
+        {
+            std::get<I>(_parts) = std::get<I>(_parts).slice(first_block, count);
+            slice_parts<I + 1>(first_block, count);
+        }
+
+        template<int I>
+        typename std::enable_if<I == sizeof...(S), bool>::type can_split_parts() const { return true; }
+        template<int I>
+        typename std::enable_if<I < sizeof...(S), bool>::type can_split_parts() const
+        {
+            return std::get<I>(_parts).can_split() && can_split_parts<I + 1>();
+        }
+
+        parts_type _parts;
+        std::tuple<typename S::storage_type*...> _sources;
+    };
+}